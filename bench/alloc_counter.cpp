@@ -0,0 +1,80 @@
+// Replaces the global allocation functions to count heap allocations for Bench::allocation_count().
+#include "bench_utils.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<std::size_t> allocations = 0;
+
+    void* allocate(const std::size_t size, const std::size_t alignment = alignof(std::max_align_t)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        void* ptr = nullptr;
+        if (alignment <= alignof(std::max_align_t)) {
+            ptr = std::malloc(size == 0 ? 1 : size);
+        } else {
+#ifdef _MSC_VER
+            ptr = _aligned_malloc(size == 0 ? 1 : size, alignment);
+#else
+            ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+        }
+        return ptr;
+    }
+
+    void deallocate(void* ptr, [[maybe_unused]] const bool aligned = false) noexcept {
+#ifdef _MSC_VER
+        if (aligned) {
+            _aligned_free(ptr);
+            return;
+        }
+#endif
+        std::free(ptr);
+    }
+}
+
+namespace ObsCamMove::Bench {
+    std::size_t allocation_count() {
+        return allocations.load(std::memory_order_relaxed);
+    }
+}
+
+void* operator new(const std::size_t size) {
+    if (void* ptr = allocate(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size) {
+    if (void* ptr = allocate(size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+    if (void* ptr = allocate(size, static_cast<std::size_t>(alignment))) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment) {
+    if (void* ptr = allocate(size, static_cast<std::size_t>(alignment))) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void* ptr) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { deallocate(ptr, true); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { deallocate(ptr, true); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { deallocate(ptr, true); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { deallocate(ptr, true); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
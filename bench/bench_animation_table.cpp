@@ -0,0 +1,49 @@
+#include "animation_table.h"
+#include "bench_utils.h"
+#include <cstdint>
+#include <format>
+
+using namespace ObsCamMove;
+
+namespace {
+    obs_sceneitem_t* fake_item(const usize index) {
+        // The table never dereferences its keys, so distinct addresses are enough
+        return reinterpret_cast<obs_sceneitem_t*>(static_cast<std::uintptr_t>(0x1000 + index * 16));
+    }
+
+    void fill_table(AnimationTable& table, const usize count) {
+        table.clear();
+        for (usize i = 0; i < count; i++) {
+            const auto easing = static_cast<CameraEasingType>(i % 11);
+            table.add(fake_item(i), { 0.0f, 0.0f }, { 1920.0f, 1080.0f }, UINT64_MAX / 2, easing);
+        }
+    }
+}
+
+int main() {
+    constexpr u64 frame_ns = 16'666'667;
+
+    std::printf("Per-frame cost of AnimationTable::advance by number of active animations\n");
+    for (const usize count : { 1, 4, 16, 64, 256, 1024 }) {
+        AnimationTable table;
+        fill_table(table, count);
+
+        u64 frame_time_ns = frame_ns;
+        const double ns_per_frame = Bench::run_benchmark(std::format("advance ({} animations)", count), 100'000, [&] {
+            frame_time_ns += frame_ns;
+            table.advance(frame_time_ns);
+            Bench::do_not_optimize(table.pos_x()[0]);
+        });
+        std::printf("%-48s %12.2f ns/item\n", "", ns_per_frame / static_cast<double>(count));
+    }
+
+    AnimationTable table;
+    usize next_item = 0;
+    Bench::run_benchmark("add + finish + remove (1 animation)", 1'000'000, [&] {
+        table.add(fake_item(next_item++), { 0.0f, 0.0f }, { 100.0f, 100.0f }, 0, CameraEasingType::Linear);
+        table.advance(frame_ns);
+        table.remove_finished([](obs_sceneitem_t*) {});
+    });
+
+    return 0;
+}
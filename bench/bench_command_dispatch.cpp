@@ -0,0 +1,104 @@
+// Command lookup and call: the former std::unordered_map of std::function against the compile-time table.
+#include "command_table.h"
+#include "message_command.h"
+#include "bench_utils.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <functional>
+#include <unordered_map>
+
+using namespace ObsCamMove;
+
+namespace {
+    constexpr std::array<StringView, 13> COMMAND_NAMES = {
+        "test_echo", "set_camera_names", "get_camera_name", "move_to", "move_by", "move_path",
+        "get_camera_position", "set_velocity", "set_target", "set_motion_limits", "set_interrupt_moves",
+        "get_stats", "subscribe_position",
+    };
+
+    String handle_command(const MessageCommand& command) {
+        return command.param_count() > 0 ? "OK" : "ERROR";
+    }
+
+    // The dispatch of MessageHandler before the table: built per handler, probed with a string hash
+    struct CommandHash {
+        using is_transparent = void;
+        usize operator()(const StringView command) const noexcept {
+            return std::hash<StringView>{}(command);
+        }
+    };
+    using HandlerMap = std::unordered_map<String, std::function<String(const MessageCommand&)>, CommandHash,
+                                          std::equal_to<>>;
+
+    HandlerMap build_map() {
+        HandlerMap handlers;
+        for (const auto name : COMMAND_NAMES) {
+            handlers[String(name)] = handle_command;
+        }
+        return handlers;
+    }
+
+    using Handler = String (*)(const MessageCommand&);
+    constexpr StaticCommandTable<COMMAND_NAMES.size()> TABLE(COMMAND_NAMES);
+    constexpr auto HANDLERS = [] {
+        std::array<Handler, COMMAND_NAMES.size()> handlers;
+        handlers.fill(handle_command);
+        return handlers;
+    }();
+
+    //! Checks that the table finds every command at its index and rejects names that are not commands.
+    bool verify_table() {
+        bool ok = true;
+        for (usize i = 0; i < COMMAND_NAMES.size(); i++) {
+            ok &= TABLE.find(COMMAND_NAMES[i]) == i;
+        }
+        for (const StringView unknown : { "", "move", "move_tox", "nove_to", "get_stat", "batch", "moveto_" }) {
+            ok &= TABLE.find(unknown) == COMMAND_NAMES.size();
+        }
+        std::printf("Table finds all %zu commands and no others: %s\n", COMMAND_NAMES.size(), ok ? "ok" : "FAILED");
+        return ok;
+    }
+}
+
+int main() {
+    if (!verify_table()) {
+        return 1;
+    }
+
+    // One parsed command per name, so the lookups cycle through the whole command set
+    std::vector<String> messages;
+    for (const auto name : COMMAND_NAMES) {
+        messages.push_back(String(name) + "(1, 2)");
+    }
+    messages.push_back("unknown_command(1, 2)");
+    std::vector<MessageCommand> commands;
+    for (const auto& message : messages) {
+        commands.emplace_back(message);
+    }
+
+    const HandlerMap map = build_map();
+    usize next = 0;
+
+    std::printf("\nLookup and call\n");
+    Bench::run_benchmark("unordered_map<String, std::function>", 10'000'000, [&] {
+        const auto& command = commands[next];
+        next = next + 1 == commands.size() ? 0 : next + 1;
+        if (const auto it = map.find(command.get_command()); it != map.end()) {
+            Bench::do_not_optimize(it->second(command));
+        }
+    });
+    Bench::run_benchmark("StaticCommandTable + function pointer", 10'000'000, [&] {
+        const auto& command = commands[next];
+        next = next + 1 == commands.size() ? 0 : next + 1;
+        if (const usize index = TABLE.find(command.get_command()); index != COMMAND_NAMES.size()) {
+            Bench::do_not_optimize(HANDLERS[index](command));
+        }
+    });
+
+    std::printf("\nSetup per MessageHandler\n");
+    Bench::run_benchmark("build unordered_map (former constructor)", 100'000, [] {
+        Bench::do_not_optimize(build_map());
+    });
+    return 0;
+}
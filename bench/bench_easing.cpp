@@ -0,0 +1,76 @@
+#include "camera_easing.h"
+#include "bench_utils.h"
+#include <cstdio>
+#include <format>
+#include <vector>
+
+using namespace ObsCamMove;
+
+namespace {
+    constexpr const char* EASING_NAMES[] = {
+        "Linear", "SmoothStep", "EaseInQuad", "EaseOutQuad", "EaseInOutQuad", "EaseInQuint",
+        "EaseOutQuint", "EaseInOutQuint", "EaseInElastic", "EaseOutElastic", "EaseInOutElastic",
+    };
+    constexpr u8 EASING_COUNT = std::size(EASING_NAMES);
+    constexpr float MAX_ERROR = 1e-4f;
+
+    //! Compares the batch API against the scalar formulas on a dense grid including both endpoints.
+    bool verify_accuracy() {
+        constexpr usize samples = 100'001;
+        std::vector<float> t(samples);
+        std::vector<float> out(samples);
+        for (usize i = 0; i < samples; i++) {
+            t[i] = static_cast<float>(i) / static_cast<float>(samples - 1);
+        }
+
+        bool passed = true;
+        std::printf("Accuracy of the batch API against CameraEasing::calculate (max. abs. error)\n");
+        for (u8 type = 0; type < EASING_COUNT; type++) {
+            const auto easing = static_cast<CameraEasingType>(type);
+            CameraEasing::calculate(easing, t, out);
+
+            float max_error = 0.0f;
+            for (usize i = 0; i < samples; i++) {
+                max_error = std::max(max_error, std::abs(out[i] - CameraEasing::calculate(easing, t[i])));
+            }
+
+            const bool ok = max_error <= MAX_ERROR && out.front() == CameraEasing::calculate(easing, 0.0f)
+                && out.back() == CameraEasing::calculate(easing, 1.0f);
+            std::printf("%-48s %12.3g %s\n", EASING_NAMES[type], max_error, ok ? "ok" : "FAILED");
+            passed = passed && ok;
+        }
+        return passed;
+    }
+}
+
+int main() {
+    if (!verify_accuracy()) {
+        return 1;
+    }
+
+    constexpr usize batch_size = 64;
+    std::vector<float> t(batch_size);
+    std::vector<float> out(batch_size);
+    for (usize i = 0; i < batch_size; i++) {
+        t[i] = static_cast<float>(i) / static_cast<float>(batch_size - 1);
+    }
+
+    std::printf("\nEasing evaluation per sample (batches of %zu)\n", batch_size);
+    for (u8 type = 0; type < EASING_COUNT; type++) {
+        const auto easing = static_cast<CameraEasingType>(type);
+
+        const double scalar_ns = Bench::run_benchmark(std::format("{} scalar", EASING_NAMES[type]), 100'000, [&] {
+            for (usize i = 0; i < batch_size; i++) {
+                out[i] = CameraEasing::calculate(easing, t[i]);
+            }
+            Bench::do_not_optimize(out[batch_size - 1]);
+        });
+        const double batch_ns = Bench::run_benchmark(std::format("{} batch", EASING_NAMES[type]), 100'000, [&] {
+            CameraEasing::calculate(easing, t, out);
+            Bench::do_not_optimize(out[batch_size - 1]);
+        });
+        std::printf("%-48s %12.2f / %.2f ns/sample\n", "", scalar_ns / batch_size, batch_ns / batch_size);
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "message_command.h"
+#include "message_command_reference.h"
+#include "bench_utils.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+using namespace ObsCamMove;
+
+namespace {
+    bool matches_reference(const String& message) {
+        const MessageCommand command(message);
+        const Bench::ReferenceCommand reference(message);
+
+        if (command.is_valid() != reference.valid || command.get_command() != reference.command) {
+            return false;
+        }
+
+        const auto params = command.get_params();
+        if (params.size() != reference.params.size()) {
+            return false;
+        }
+        for (usize i = 0; i < params.size(); i++) {
+            if (params[i] != reference.params[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<String> load_corpus(const std::filesystem::path& directory) {
+        std::vector<String> corpus;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            std::ifstream file(entry.path(), std::ios::binary);
+            corpus.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        return corpus;
+    }
+
+    //! Checks the corpus and random single-byte mutations of it against the regex parser.
+    bool verify_against_reference(const std::vector<String>& corpus) {
+        constexpr char interesting[] = "(),; \t\"_aZ09-+";
+        std::mt19937 random(42);
+        usize checked = 0;
+        usize failed = 0;
+
+        for (const auto& seed : corpus) {
+            for (int round = 0; round < 200; round++) {
+                String message = seed;
+                if (round > 0 && !message.empty()) {
+                    const usize position = random() % message.size();
+                    switch (random() % 3) {
+                        case 0: message[position] = interesting[random() % (sizeof(interesting) - 1)]; break;
+                        case 1: message.erase(position, 1); break;
+                        default: message.insert(position, 1, interesting[random() % (sizeof(interesting) - 1)]); break;
+                    }
+                }
+
+                checked++;
+                if (!matches_reference(message)) {
+                    std::printf("Mismatch for input: \"%s\"\n", message.c_str());
+                    failed++;
+                }
+            }
+        }
+
+        std::printf("Parser matches regex reference: %zu/%zu inputs\n", checked - failed, checked);
+        return failed == 0;
+    }
+}
+
+int main(const int argc, char* argv[]) {
+    const std::filesystem::path corpus_dir = argc > 1 ? argv[1] : MESSAGE_COMMAND_CORPUS_DIR;
+    if (!verify_against_reference(load_corpus(corpus_dir))) {
+        return 1;
+    }
+
+    std::printf("\nParsing a command\n");
+    for (const String message : { "get_camera_position()", "move_to(100, 200, 500, 3);",
+                                  "move_by(-10, 20, 250, 0, \"scn_overlay\");" }) {
+        Bench::run_benchmark("regex  " + message, 200'000, [&] {
+            const Bench::ReferenceCommand command(message);
+            Bench::do_not_optimize(command.params);
+        });
+        Bench::run_benchmark("parser " + message, 2'000'000, [&] {
+            const MessageCommand command(message);
+            Bench::do_not_optimize(command.get_params());
+        });
+    }
+
+    std::printf("\nParsing the integer parameters of move_to(100, 200, 500, 3)\n");
+    const MessageCommand command("move_to(100, 200, 500, 3)");
+    Bench::run_benchmark("std::stoi", 2'000'000, [&] {
+        int sum = 0;
+        for (const auto param : command.get_params()) sum += std::stoi(String(param));
+        Bench::do_not_optimize(sum);
+    });
+    Bench::run_benchmark("parse_int", 2'000'000, [&] {
+        int sum = 0;
+        for (const auto param : command.get_params()) {
+            int value = 0;
+            (void)parse_int(param, value);
+            sum += value;
+        }
+        Bench::do_not_optimize(sum);
+    });
+
+    return 0;
+}
@@ -0,0 +1,683 @@
+// End-to-end cost of control commands, from the received message to the scene item, against the libobs stand-in.
+#include "message_handler.h"
+#include "message_command.h"
+#include "binary_protocol.h"
+#include "animation_scheduler.h"
+#include "camera_controller.h"
+#include "position_publisher.h"
+#include "motion_constraints.h"
+#include "camera_easing.h"
+#include "transform_channels.h"
+#include "logger.h"
+#include "obs_stub.h"
+#include "bench_utils.h"
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <format>
+#include <memory>
+#include <vector>
+
+using namespace ObsCamMove;
+
+namespace {
+    constexpr u64 FRAME_NS = 16'666'667;
+    constexpr int MOVE_DURATION_MS = 500;
+    constexpr int MOVE_FRAMES = MOVE_DURATION_MS * 1'000'000 / FRAME_NS + 2;
+
+    u64 frame_time_ns = 0;
+
+    //! Stands in for a connection and counts the position updates pushed to it.
+    class CountingSubscriber final : public PositionSubscriber {
+    public:
+        usize updates = 0;
+        std::shared_ptr<const String> last_update;
+
+        FramingMode get_framing_mode() const override { return FramingMode::Newline; }
+        void push_update(std::shared_ptr<const String> update) override {
+            updates++;
+            last_update = std::move(update);
+        }
+    };
+
+    void run_frames(const int count) {
+        for (int i = 0; i < count; i++) {
+            frame_time_ns += FRAME_NS;
+            ObsStub::video_tick(frame_time_ns);
+        }
+    }
+
+    String binary_frame(const BinaryOpcode opcode, const i32 x = 0, const i32 y = 0) {
+        String frame(BinaryFrame::SIZE, '\0');
+        frame[0] = static_cast<char>(opcode);
+        for (int i = 0; i < 4; i++) {
+            frame[4 + i] = static_cast<char>(static_cast<u32>(x) >> (8 * i));
+            frame[8 + i] = static_cast<char>(static_cast<u32>(y) >> (8 * i));
+        }
+        return frame;
+    }
+
+    //! Scene searches per get_camera_position, with a warm cache or after a scene change.
+    double scene_searches_per_query(MessageHandler& handler, const bool scene_changed) {
+        constexpr int queries = 1000;
+        const usize before = ObsStub::scene_search_count();
+        for (int i = 0; i < queries; i++) {
+            if (scene_changed) ObsStub::send_frontend_event(OBS_FRONTEND_EVENT_SCENE_CHANGED);
+            (void)handler.process_message("get_camera_position()");
+        }
+        return static_cast<double>(ObsStub::scene_search_count() - before) / queries;
+    }
+
+    //! Moves the camera once and checks that the stand-in scene item arrives at the target.
+    bool verify_move(MessageHandler& handler, obs_sceneitem_t* camera) {
+        const auto reply = handler.process_message("move_to(640, 360, 500, 3)");
+        run_frames(MOVE_FRAMES);
+
+        vec2 pos;
+        obs_sceneitem_get_pos(camera, &pos);
+        const bool ok = reply == "OK" && pos.x == 640.0f && pos.y == 360.0f
+            && !AnimationScheduler::get_instance().is_animating(camera);
+        std::printf("move_to reaches its target within %d frames: %s\n", MOVE_FRAMES, ok ? "ok" : "FAILED");
+        return ok;
+    }
+
+    //! Moves the camera along a path and checks that it ends on the last waypoint.
+    bool verify_path(MessageHandler& handler, obs_sceneitem_t* camera) {
+        const auto reply = handler.process_message("move_path(200, 0, 400, 300, 200, 600, 500, 3)");
+        run_frames(MOVE_FRAMES);
+
+        vec2 pos;
+        obs_sceneitem_get_pos(camera, &pos);
+        const bool ok = reply == "OK" && pos.x == 200.0f && pos.y == 600.0f;
+        std::printf("move_path ends on the last waypoint within %d frames: %s\n", MOVE_FRAMES, ok ? "ok" : "FAILED");
+        return ok;
+    }
+
+    //! Retargets a running move and checks that the per-frame step does not jump or stall.
+    bool verify_interrupt(MessageHandler& handler, obs_sceneitem_t* camera) {
+        (void)handler.process_message("set_interrupt_moves(1)");
+        bool ok = true;
+        // SmoothStep starts at rest, so its first step is only the carried velocity; Linear and EaseOutQuad
+        // start with a slope of their own, which the carry has to make up for
+        for (const auto& [easing, name] : { std::pair{ 1, "SmoothStep" }, { 0, "Linear" }, { 3, "EaseOutQuad" } }) {
+            (void)handler.process_message("set_position(0, 0)");
+            run_frames(1);
+            (void)handler.process_message(std::format("move_to(1000, 0, 1000, {})", easing));
+            run_frames(20);
+
+            vec2 before, pos, after;
+            obs_sceneitem_get_pos(camera, &before);
+            run_frames(1);
+            obs_sceneitem_get_pos(camera, &pos);
+            const auto reply = handler.process_message(std::format("move_to(1000, 500, 1000, {})", easing));
+            run_frames(1);
+            obs_sceneitem_get_pos(camera, &after);
+            run_frames(MOVE_FRAMES * 2);
+
+            const float step_before = std::hypot(pos.x - before.x, pos.y - before.y);
+            const float step_after = std::hypot(after.x - pos.x, after.y - pos.y);
+            const bool speed_ok = reply == "OK" && std::abs(step_after - step_before) < 0.05f * step_before;
+            std::printf("Interrupted %s move keeps its speed (%.2f -> %.2f px/frame): %s\n", name, step_before,
+                        step_after, speed_ok ? "ok" : "FAILED");
+            ok &= speed_ok;
+        }
+        (void)handler.process_message("set_interrupt_moves(0)");
+        return ok;
+    }
+
+    //! Scales the camera while it moves along a path and checks that the path runs on and ends on its last
+    //! waypoint instead of being dropped.
+    bool verify_path_interrupt(MessageHandler& handler, obs_sceneitem_t* camera) {
+        (void)handler.process_message("set_interrupt_moves(1)");
+        (void)handler.process_message("set_position(0, 0)");
+        run_frames(1);
+        (void)handler.process_message("move_path(200, 0, 400, 300, 200, 600, 500, 0)");
+        run_frames(10);
+
+        vec2 before, pos, after;
+        obs_sceneitem_get_pos(camera, &before);
+        run_frames(1);
+        obs_sceneitem_get_pos(camera, &pos);
+        const auto reply = handler.process_message("scale_to(1.5, 1.5, 500, 0)");
+        run_frames(1);
+        obs_sceneitem_get_pos(camera, &after);
+        run_frames(MOVE_FRAMES);
+
+        vec2 end;
+        obs_sceneitem_get_pos(camera, &end);
+        const float step_before = std::hypot(pos.x - before.x, pos.y - before.y);
+        const float step_after = std::hypot(after.x - pos.x, after.y - pos.y);
+        const bool ok = reply == "OK" && std::abs(step_after - step_before) < 0.05f * step_before
+            && end.x == 200.0f && end.y == 600.0f;
+        std::printf("Scaling during move_path keeps the path (%.2f -> %.2f px/frame): %s\n", step_before, step_after,
+                    ok ? "ok" : "FAILED");
+        (void)handler.process_message("scale_to(1, 1, 0, 0)");
+        (void)handler.process_message("set_interrupt_moves(0)");
+        run_frames(1);
+        return ok;
+    }
+
+    //! Streams set_target and checks that the integrator stops exactly on it.
+    bool verify_target(MessageHandler& handler, obs_sceneitem_t* camera) {
+        const auto reply = handler.process_message("set_target(100, 50)");
+        run_frames(120);
+
+        vec2 pos;
+        obs_sceneitem_get_pos(camera, &pos);
+        const bool ok = reply == "OK" && pos.x == 100.0f && pos.y == 50.0f;
+        std::printf("set_target stops on the target within 120 frames: %s\n", ok ? "ok" : "FAILED");
+        return ok;
+    }
+
+    //! Subscribes many clients and checks that each position change is pushed once per frame to all of them
+    //! as the same buffer, and that nothing is pushed while the camera stands still.
+    bool verify_subscription(MessageHandler& handler, std::vector<std::shared_ptr<CountingSubscriber>>& subscribers) {
+        bool replies_ok = true;
+        for (const auto& subscriber : subscribers) {
+            replies_ok &= handler.process_message("subscribe_position(120)", { subscriber }) == "OK";
+        }
+        run_frames(1); // Initial position
+        (void)handler.process_message("move_to(320, 180, 500, 3)");
+        run_frames(MOVE_FRAMES + 10);
+
+        // The initial position, then every frame of the move but its first, which is still at the start
+        const auto& first = *subscribers.front();
+        bool ok = replies_ok && first.updates == MOVE_FRAMES
+            && *first.last_update == "camera-position: x=320, y=180\n";
+        for (const auto& subscriber : subscribers) {
+            ok &= subscriber->updates == first.updates && subscriber->last_update == first.last_update;
+        }
+        std::printf("subscribe_position pushes each change once, shared by %zu subscribers: %s\n",
+                    subscribers.size(), ok ? "ok" : "FAILED");
+        for (const auto& subscriber : subscribers) {
+            (void)handler.process_message("subscribe_position(0)", { subscriber });
+        }
+        return ok;
+    }
+
+    //! Subscribes with a rate far below 1 Hz and checks that it is clamped to one update per second.
+    bool verify_subscription_rate(MessageHandler& handler) {
+        // The commands only pass whole rates, so this goes to the publisher directly
+        const auto subscriber = std::make_shared<CountingSubscriber>();
+        PositionPublisher::get_instance().subscribe(subscriber, 1e-12f);
+        run_frames(1); // Initial position
+        (void)handler.process_message("move_to(0, 0, 500, 3)");
+        run_frames(MOVE_FRAMES + 10);
+        const usize updates_during_move = subscriber->updates;
+        run_frames(60 - MOVE_FRAMES - 10);
+
+        const bool ok = updates_during_move == 1 && subscriber->updates == 2
+            && *subscriber->last_update == "camera-position: x=0, y=0\n";
+        std::printf("subscribe_position clamps a tiny rate to 1 Hz (%zu updates in 1 s): %s\n",
+                    subscriber->updates, ok ? "ok" : "FAILED");
+        PositionPublisher::get_instance().unsubscribe(subscriber.get());
+        return ok;
+    }
+
+    //! Moves two items in one batch and checks that they start with the same frame, and that a batch with
+    //! a failing command starts none of its moves.
+    bool verify_batch(MessageHandler& handler, obs_sceneitem_t* camera, obs_sceneitem_t* overlay) {
+        vec2 camera_start, overlay_start;
+        obs_sceneitem_get_pos(camera, &camera_start);
+        obs_sceneitem_get_pos(overlay, &overlay_start);
+        const auto reply = handler.process_message(
+            R"(batch(move_to(400, 300, 500, 3); move_to(500, 100, 500, 3, "Overlay")))");
+        run_frames(MOVE_FRAMES / 2);
+
+        // Moves that started with the same frame have covered the same fraction of their way
+        vec2 camera_pos, overlay_pos;
+        obs_sceneitem_get_pos(camera, &camera_pos);
+        obs_sceneitem_get_pos(overlay, &overlay_pos);
+        const float camera_fraction = (camera_pos.x - camera_start.x) / (400.0f - camera_start.x);
+        const float overlay_fraction = (overlay_pos.x - overlay_start.x) / (500.0f - overlay_start.x);
+        run_frames(MOVE_FRAMES);
+
+        const auto failed_reply = handler.process_message("batch(move_to(0, 0, 500, 3); move_to(1, 2))");
+        run_frames(MOVE_FRAMES);
+        obs_sceneitem_get_pos(camera, &camera_pos);
+        obs_sceneitem_get_pos(overlay, &overlay_pos);
+
+        const bool ok = reply == "OK; OK" && camera_fraction > 0.0f && std::abs(camera_fraction - overlay_fraction) < 1e-4f
+            && failed_reply.value_or("").starts_with("ERROR") && camera_pos.x == 400.0f && overlay_pos.x == 500.0f;
+        std::printf("batch starts its moves with the same frame, or none: %s\n", ok ? "ok" : "FAILED");
+
+        // A command that is no staged animation, a missing item and a moving item each fail the whole batch
+        // before anything happened, and a discarded move does not take the camera over from velocity control
+        (void)handler.process_message("move_to(0, 0, 500, 3, \"Overlay\")");
+        (void)handler.process_message("set_velocity(60, 0)");
+        const auto unbatchable = handler.process_message("batch(move_to(0, 0, 500, 3); set_camera_names(\"Overlay\"))");
+        const auto missing = handler.process_message("batch(move_to(0, 0, 500, 3); move_to(0, 0, 500, 3, \"Missing\"))");
+        const auto moving = handler.process_message("batch(move_to(0, 0, 500, 3); move_to(1, 2, 500, 3, \"Overlay\"))");
+        obs_sceneitem_get_pos(camera, &camera_pos);
+        run_frames(MOVE_FRAMES);
+        vec2 camera_end;
+        obs_sceneitem_get_pos(camera, &camera_end);
+        (void)handler.process_message("set_position(400, 300)");
+        run_frames(1);
+
+        const bool atomic_ok = unbatchable.value_or("").starts_with("ERROR") && missing.value_or("").starts_with("ERROR")
+            && moving.value_or("").starts_with("ERROR") && handler.process_message("get_camera_name()") == "Webcam"
+            && camera_end.x > camera_pos.x + 20.0f;
+        std::printf("batch fails as a whole on a foreign command, a missing or a moving item: %s\n",
+                    atomic_ok ? "ok" : "FAILED");
+        return ok && atomic_ok;
+    }
+
+    //! Pans and zooms the camera in one animate command, and crops and fades it in a batch with a move;
+    //! checks that all channels of a frame belong to the same progress and end exactly on their targets.
+    bool verify_transform(MessageHandler& handler, obs_sceneitem_t* camera) {
+        const auto start = read_transform(camera, ALL_CHANNELS);
+        const auto reply = handler.process_message("animate(500, 3, x=300, y=200, scale=2, rotation=90, opacity=0)");
+        run_frames(MOVE_FRAMES / 2);
+
+        const auto middle = read_transform(camera, ALL_CHANNELS);
+        const auto fraction = [&](const TransformChannel channel, const float target) {
+            return (middle.get(channel) - start.get(channel)) / (target - start.get(channel));
+        };
+        const float pan_fraction = fraction(TransformChannel::PosX, 300.0f);
+        const bool in_sync = pan_fraction > 0.0f && pan_fraction < 1.0f
+            && std::abs(fraction(TransformChannel::ScaleX, 2.0f) - pan_fraction) < 1e-4f
+            && std::abs(fraction(TransformChannel::Rotation, 90.0f) - pan_fraction) < 1e-4f
+            && std::abs(fraction(TransformChannel::Opacity, 0.0f) - pan_fraction) < 1e-4f;
+        run_frames(MOVE_FRAMES);
+
+        const auto batch_reply = handler.process_message(
+            "batch(move_to(100, 100, 500, 3); crop_to(10, 20, 30, 40.4, 500, 3); fade_in(500); zoom(0.5, 500, 3))");
+        run_frames(MOVE_FRAMES);
+
+        const auto end = read_transform(camera, ALL_CHANNELS);
+        const bool ok = reply == "OK" && batch_reply == "OK; OK; OK; OK" && in_sync
+            && end.get(TransformChannel::PosX) == 100.0f && end.get(TransformChannel::ScaleX) == 1.0f
+            && end.get(TransformChannel::ScaleY) == 1.0f && end.get(TransformChannel::Rotation) == 90.0f
+            && end.get(TransformChannel::CropBottom) == 40.0f && end.get(TransformChannel::Opacity) == 1.0f
+            && handler.process_message("get_scale()") == "camera-scale: x=1, y=1"
+            && !AnimationScheduler::get_instance().is_animating(camera);
+        std::printf("Transform channels advance in sync and land on their targets: %s\n", ok ? "ok" : "FAILED");
+        (void)handler.process_message("rotate(0, 0)");
+        run_frames(1);
+        return ok;
+    }
+
+    //! Checks that the opacity filter is only updated when the opacity changes, and that a source shown by
+    //! two scene items is not faded at all.
+    bool verify_opacity(MessageHandler& handler, obs_sceneitem_t* camera) {
+        const usize updates_before = ObsStub::source_update_count();
+        const auto reply = handler.process_message("animate(500, 3, x=200, opacity=1)");
+        run_frames(MOVE_FRAMES);
+        const usize updates = ObsStub::source_update_count() - updates_before;
+
+        obs_sceneitem_t* shared = ObsStub::add_shared_item(ObsStub::create_scene("Second"), camera);
+        (void)handler.process_message("fade_out(500)");
+        const auto batch_reply = handler.process_message("batch(move_to(0, 0, 500, 3); fade_out(500))");
+        run_frames(MOVE_FRAMES);
+        const float opacity = read_transform(camera, channel_bit(TransformChannel::Opacity)).get(TransformChannel::Opacity);
+        vec2 pos;
+        obs_sceneitem_get_pos(camera, &pos);
+        ObsStub::remove_item(shared);
+
+        const bool ok = reply == "OK" && updates == 1 && batch_reply.value_or("").starts_with("ERROR")
+            && opacity == 1.0f && pos.x == 200.0f;
+        std::printf("Opacity is written once per change and never to a shared source (%zu updates): %s\n", updates,
+                    ok ? "ok" : "FAILED");
+        return ok;
+    }
+
+    //! Follows an item that jumps and checks that the webcam reacts in the same frame, approaches without
+    //! overshooting and stays put while the item moves within the dead zone.
+    bool verify_follow(MessageHandler& handler, obs_sceneitem_t* camera, obs_sceneitem_t* overlay) {
+        const vec2 target = { 800.0f, 400.0f };
+        obs_sceneitem_set_pos(overlay, &target);
+        const auto reply = handler.process_message(R"(follow("Overlay", -50, 0, 0, 10))");
+
+        vec2 start, pos;
+        obs_sceneitem_get_pos(camera, &start);
+        run_frames(1);
+        obs_sceneitem_get_pos(camera, &pos);
+        const bool same_frame = pos.x != start.x;
+
+        bool monotonic = true;
+        for (int i = 0; i < 120; i++) {
+            const float previous_x = pos.x;
+            run_frames(1);
+            obs_sceneitem_get_pos(camera, &pos);
+            monotonic &= pos.x >= previous_x && pos.x <= 750.0f;
+        }
+        const bool arrived = std::abs(pos.x - 750.0f) < 0.5f && std::abs(pos.y - 400.0f) < 0.5f;
+
+        (void)handler.process_message(R"(follow("Overlay", -50, 0, 100, 10))");
+        const vec2 nearby = { 850.0f, 400.0f };
+        obs_sceneitem_set_pos(overlay, &nearby);
+        vec2 before;
+        obs_sceneitem_get_pos(camera, &before);
+        run_frames(30);
+        obs_sceneitem_get_pos(camera, &pos);
+        const bool dead_zone = std::abs(pos.x - before.x) < 1.0f;
+        (void)handler.process_message("stop_follow()");
+
+        const bool ok = reply == "OK" && same_frame && monotonic && arrived && dead_zone;
+        std::printf("follow reacts in the same frame and settles without overshoot: %s\n", ok ? "ok" : "FAILED");
+        return ok;
+    }
+
+    //! Moves the webcam against its bounds, while locked and towards a keep-out item, and checks where it
+    //! stops; the keep-out index must be built once, not per frame of the move.
+    bool verify_constraints(MessageHandler& handler, obs_sceneitem_t* camera) {
+        bool replies_ok = handler.process_message("set_bounds(0, 0, 1920, 1080)") == "OK";
+        (void)handler.process_message("move_to(1800, 1000, 500, 3)");
+        run_frames(MOVE_FRAMES);
+        vec2 bounded;
+        obs_sceneitem_get_pos(camera, &bounded);
+
+        replies_ok &= handler.process_message("lock_position(1)") == "OK";
+        (void)handler.process_message("move_to(0, 0, 500, 3)");
+        run_frames(MOVE_FRAMES);
+        vec2 locked;
+        obs_sceneitem_get_pos(camera, &locked);
+
+        replies_ok &= handler.process_message("clear_constraints()") == "OK";
+        (void)handler.process_message("set_position(1200, 420)");
+        run_frames(1);
+        replies_ok &= handler.process_message(R"(set_keep_out("", "Banner"))") == "OK";
+        const usize searches_before = ObsStub::scene_search_count();
+        (void)handler.process_message("move_to(400, 420, 500, 0)");
+        run_frames(MOVE_FRAMES);
+        const usize index_builds = ObsStub::scene_search_count() - searches_before;
+        vec2 kept_out;
+        obs_sceneitem_get_pos(camera, &kept_out);
+        replies_ok &= handler.process_message("clear_constraints()") == "OK";
+
+        // The 320x180 webcam stays within 1920x1080, and stops at the right edge of the banner at x=1000
+        const bool ok = replies_ok && bounded.x == 1600.0f && bounded.y == 900.0f && locked.x == 1600.0f
+            && locked.y == 900.0f && kept_out.x == 1000.0f && kept_out.y == 420.0f && index_builds == 1;
+        std::printf("Bounds, lock and keep-out stop the webcam where they should: %s\n", ok ? "ok" : "FAILED");
+        return ok;
+    }
+
+    //! Keep-out rectangles far apart must not blow up the grid, and queries must still find them.
+    bool verify_sparse_grid() {
+        RectGrid grid;
+        const Rect rects[] = { { -1e6f, -1e6f, -1e6f + 100.0f, -1e6f + 100.0f }, { 0.0f, 0.0f, 100.0f, 100.0f },
+                               { 1e6f, 1e6f, 1e6f + 100.0f, 1e6f + 100.0f } };
+        grid.build(rects);
+        usize found = 0;
+        grid.query({ 50.0f, 50.0f, 60.0f, 60.0f }, [&](const u32 index) { found += rects[index].overlaps({ 50.0f, 50.0f, 60.0f, 60.0f }); });
+        usize far_found = 0;
+        grid.query({ 1e6f, 1e6f, 1e6f + 10.0f, 1e6f + 10.0f }, [&](const u32 index) { far_found += index == 2; });
+
+        const bool ok = grid.cell_count() <= RectGrid::MAX_CELLS && found == 1 && far_found == 1;
+        std::printf("Keep-out grid stays small for rectangles 2e6 px apart (%zu cells): %s\n", grid.cell_count(),
+                    ok ? "ok" : "FAILED");
+        return ok;
+    }
+
+    //! Queries answer from the state the last frame published without searching the scene, report the
+    //! progress of a move, and still see a change of the camera names before the next frame.
+    bool verify_state(MessageHandler& handler, obs_sceneitem_t* camera) {
+        (void)handler.process_message("set_position(100, 100)");
+        run_frames(1);
+        (void)handler.process_message("move_to(500, 100, 500, 0)");
+        run_frames(MOVE_FRAMES / 2);
+
+        const usize searches_before = ObsStub::scene_search_count();
+        const auto moving = handler.process_message("get_camera_state()").value_or("");
+        const auto position = handler.process_message("get_camera_position()").value_or("");
+        const bool no_searches = ObsStub::scene_search_count() == searches_before;
+        vec2 pos;
+        obs_sceneitem_get_pos(camera, &pos);
+
+        run_frames(MOVE_FRAMES);
+        const auto stopped = handler.process_message("get_camera_state()").value_or("");
+        (void)handler.process_message(R"(set_camera_names("Overlay"))");
+        const auto renamed = handler.process_message("get_camera_name()").value_or("");
+        (void)handler.process_message(R"(set_camera_names("Camera", "Webcam"))");
+        run_frames(1);
+
+        const bool ok = no_searches && position == std::format("camera-position: x={}, y={}", pos.x, pos.y)
+            && moving.starts_with("camera-state: scene=Main, camera=Webcam, ") && moving.contains("moving=true")
+            && stopped.ends_with("moving=false, progress=0") && renamed == "Overlay";
+        std::printf("Queries answer from the published camera state: %s\n", ok ? "ok" : "FAILED");
+        return ok;
+    }
+
+    //! Reads the f32 at offset of a binary reply.
+    float binary_f32(const String& reply, const usize offset) {
+        u32 raw = 0;
+        for (usize i = 0; i < 4; i++) {
+            raw |= static_cast<u32>(static_cast<u8>(reply[offset + i])) << (8 * i);
+        }
+        return std::bit_cast<float>(raw);
+    }
+
+    //! Checks that the binary queries reply with little-endian floats instead of the text replies, and that
+    //! errors stay text.
+    bool verify_binary(MessageHandler& handler, obs_sceneitem_t* camera) {
+        (void)handler.process_message("set_position(123.5, -45.25)");
+        run_frames(1);
+
+        String position, scale, state;
+        handler.process_binary_message(binary_frame(BinaryOpcode::GetCameraPosition), position);
+        handler.process_binary_message(binary_frame(BinaryOpcode::GetCameraScale), scale);
+        handler.process_binary_message(binary_frame(BinaryOpcode::GetCameraState), state);
+        vec2 item_scale;
+        obs_sceneitem_get_scale(camera, &item_scale);
+
+        (void)handler.process_message(R"(set_camera_names("Missing"))");
+        run_frames(1);
+        String error;
+        handler.process_binary_message(binary_frame(BinaryOpcode::GetCameraPosition), error);
+        (void)handler.process_message(R"(set_camera_names("Camera", "Webcam"))");
+        run_frames(1);
+
+        constexpr usize H = BINARY_REPLY_HEADER_SIZE;
+        const bool ok = position.size() == H + BINARY_VEC2_PAYLOAD_SIZE && position[1] == 0
+            && binary_f32(position, H) == 123.5f && binary_f32(position, H + 4) == -45.25f
+            && scale.size() == H + BINARY_VEC2_PAYLOAD_SIZE && binary_f32(scale, H) == item_scale.x
+            && state.size() == H + BINARY_STATE_PAYLOAD_SIZE && binary_f32(state, H) == 123.5f
+            && binary_f32(state, H + 8) == item_scale.x && binary_f32(state, H + 16) == 0.0f && state[H + 20] == 0
+            && error.size() > H && error[1] == static_cast<char>(BinaryStatus::Error)
+            && StringView(error).substr(H).starts_with("ERROR");
+        std::printf("Binary queries reply with little-endian floats: %s\n", ok ? "ok" : "FAILED");
+        return ok;
+    }
+
+    //! Resets the statistics, moves once and checks that get_stats counted the command and the animation,
+    //! and that the move ended less than a frame after its deadline.
+    bool verify_stats(MessageHandler& handler) {
+        (void)handler.process_message("get_stats(1)");
+        (void)handler.process_message("move_to(0, 0, 500, 3)");
+        run_frames(MOVE_FRAMES);
+
+        const auto stats = handler.process_message("get_stats()").value_or("");
+        const auto overshoot = Metrics::get_instance().move_overshoot.summarize();
+        const bool ok = stats.contains(R"("move_to":{"count":1,"errors":0,)")
+            && stats.contains(std::format(R"("moves_started":1,"frames_applied":{},"moves_finished":1,)", MOVE_FRAMES))
+            && overshoot.count == 1 && overshoot.max < FRAME_NS;
+        std::printf("get_stats counts commands and animation frames: %s\n", ok ? "ok" : "FAILED");
+        return ok;
+    }
+}
+
+int main() {
+    // Stand-in for the scene a streamer would have: a few overlays and the webcam
+    obs_scene_t* scene = ObsStub::create_scene("Main");
+    obs_sceneitem_t* overlay = nullptr;
+    for (const char* name : { "Background", "Overlay", "Chat", "Alerts" }) {
+        obs_sceneitem_t* item = ObsStub::add_item(scene, name);
+        if (StringView(name) == "Overlay") overlay = item;
+    }
+    (void)ObsStub::add_item(scene, "Banner", { 800.0f, 400.0f }, { 200.0f, 100.0f });
+    obs_sceneitem_t* camera = ObsStub::add_item(scene, "Webcam", { 100.0f, 100.0f }, { 320.0f, 180.0f });
+
+    AnimationScheduler::get_instance().start();
+    CameraController::getInstance().start();
+    MotionConstraints::get_instance().start();
+    PositionPublisher::get_instance().start();
+
+    MessageHandler handler;
+    (void)handler.process_message(R"(set_camera_names("Camera", "Webcam"))");
+    if (!verify_move(handler, camera) || !verify_path(handler, camera) || !verify_interrupt(handler, camera)
+        || !verify_path_interrupt(handler, camera)
+        || !verify_target(handler, camera) || !verify_transform(handler, camera) || !verify_opacity(handler, camera)
+        || !verify_stats(handler)) {
+        return 1;
+    }
+    std::vector<std::shared_ptr<CountingSubscriber>> subscribers(100);
+    for (auto& subscriber : subscribers) {
+        subscriber = std::make_shared<CountingSubscriber>();
+    }
+    if (!verify_subscription(handler, subscribers) || !verify_subscription_rate(handler)
+        || !verify_batch(handler, camera, overlay) || !verify_follow(handler, camera, overlay) || !verify_constraints(handler, camera)
+        || !verify_sparse_grid() || !verify_state(handler, camera) || !verify_binary(handler, camera)) {
+        return 1;
+    }
+
+    std::printf("\nParsing\n");
+    Bench::run_benchmark("MessageCommand move_to(100, 200, 500, 3)", 2'000'000, [] {
+        const MessageCommand command("move_to(100, 200, 500, 3)");
+        Bench::do_not_optimize(command.get_params());
+    });
+
+    std::printf("\nDispatch (parse + handler + reply)\n");
+    Bench::run_benchmark("test_echo(\"ping\")", 1'000'000, [&] {
+        Bench::do_not_optimize(handler.process_message(R"(test_echo("ping"))"));
+    });
+    Bench::run_benchmark("get_camera_name()", 1'000'000, [&] {
+        Bench::do_not_optimize(handler.process_message("get_camera_name()"));
+    });
+    Bench::run_benchmark("get_camera_state()", 1'000'000, [&] {
+        Bench::do_not_optimize(handler.process_message("get_camera_state()"));
+    });
+    Bench::run_benchmark("get_stats()", 100'000, [&] {
+        Bench::do_not_optimize(handler.process_message("get_stats()"));
+    });
+
+    std::printf("\nEasing evaluation\n");
+    float t = 0.0f;
+    Bench::run_benchmark("EaseInOutQuint scalar", 10'000'000, [&] {
+        t = t >= 1.0f ? 0.0f : t + 1.0f / 1024.0f;
+        Bench::do_not_optimize(CameraEasing::calculate(CameraEasingType::EaseInOutQuint, t));
+    });
+
+    std::printf("\nPosition queries\n");
+    Bench::run_benchmark("get_camera_position() text", 1'000'000, [&] {
+        Bench::do_not_optimize(handler.process_message("get_camera_position()"));
+    });
+    const String position_frame = binary_frame(BinaryOpcode::GetCameraPosition);
+    String binary_reply;
+    Bench::run_benchmark("get_camera_position binary", 1'000'000, [&] {
+        binary_reply.clear();
+        handler.process_binary_message(position_frame, binary_reply);
+        Bench::do_not_optimize(binary_reply);
+    });
+    Bench::run_benchmark("get_camera_position() after scene change", 1'000'000, [&] {
+        ObsStub::send_frontend_event(OBS_FRONTEND_EVENT_SCENE_CHANGED);
+        Bench::do_not_optimize(handler.process_message("get_camera_position()"));
+    });
+    std::printf("%-48s %12.2f scene searches/op (warm), %.2f after a scene change\n", "",
+        scene_searches_per_query(handler, false), scene_searches_per_query(handler, true));
+
+    std::printf("\nFull move animations (%d frames per move)\n", MOVE_FRAMES);
+    bool forward = true;
+    const double move_ns = Bench::run_benchmark("move_to + frames until finished", 20'000, [&] {
+        (void)handler.process_message(forward ? "move_to(640, 360, 500, 3)" : "move_to(0, 0, 500, 9)");
+        run_frames(MOVE_FRAMES);
+        forward = !forward;
+    });
+    std::printf("%-48s %12.1f ns/frame\n", "", move_ns / MOVE_FRAMES);
+    const double path_ns = Bench::run_benchmark("move_path (4 waypoints) + frames until finished", 20'000, [&] {
+        (void)handler.process_message(forward
+            ? "move_path(200, 0, 400, 300, 200, 600, 0, 300, 500, 0)"
+            : "move_path(600, 300, 0, 0, 500, 9)");
+        run_frames(MOVE_FRAMES);
+        forward = !forward;
+    });
+    std::printf("%-48s %12.1f ns/frame\n", "", path_ns / MOVE_FRAMES);
+    Bench::run_benchmark("3 moves as separate messages + frames", 20'000, [&] {
+        (void)handler.process_message(forward ? "move_to(640, 360, 500, 3)" : "move_to(0, 0, 500, 9)");
+        (void)handler.process_message(forward ? R"(move_to(10, 10, 500, 3, "Overlay"))" : R"(move_to(0, 0, 500, 3, "Overlay"))");
+        (void)handler.process_message(forward ? R"(move_to(20, 20, 500, 3, "Chat"))" : R"(move_to(0, 0, 500, 3, "Chat"))");
+        run_frames(MOVE_FRAMES);
+        forward = !forward;
+    });
+    Bench::run_benchmark("3 moves as one batch + frames", 20'000, [&] {
+        (void)handler.process_message(forward
+            ? R"(batch(move_to(640, 360, 500, 3); move_to(10, 10, 500, 3, "Overlay"); move_to(20, 20, 500, 3, "Chat")))"
+            : R"(batch(move_to(0, 0, 500, 9); move_to(0, 0, 500, 3, "Overlay"); move_to(0, 0, 500, 3, "Chat")))");
+        run_frames(MOVE_FRAMES);
+        forward = !forward;
+    });
+    Bench::run_benchmark("video tick without animations", 10'000'000, [] {
+        run_frames(1);
+    });
+
+    std::printf("\nContinuous control\n");
+    int step = 0;
+    Bench::run_benchmark("set_velocity(vx, vy) text", 1'000'000, [&] {
+        step = (step + 1) & 255;
+        Bench::do_not_optimize(handler.process_message(step & 1 ? "set_velocity(120, -40)" : "set_velocity(-120, 40)"));
+    });
+    const String velocity_frames[] = {
+        binary_frame(BinaryOpcode::SetVelocity, 120, -40), binary_frame(BinaryOpcode::SetVelocity, -120, 40)
+    };
+    Bench::run_benchmark("set_velocity binary", 1'000'000, [&] {
+        step = (step + 1) & 255;
+        binary_reply.clear();
+        handler.process_binary_message(velocity_frames[step & 1], binary_reply);
+        Bench::do_not_optimize(binary_reply);
+    });
+    Bench::run_benchmark("video tick with velocity control", 1'000'000, [&] {
+        step = (step + 1) & 255;
+        CameraController::getInstance().set_velocity(step & 128 ? 300.0f : -300.0f, 0.0f);
+        run_frames(1);
+    });
+    (void)handler.process_message("set_velocity(0, 0)");
+
+    std::printf("\nConstraints\n");
+    (void)handler.process_message("set_position(100, 100)");
+    run_frames(1);
+    int block_count = 0;
+    for (const int keep_out_count : { 10, 1000 }) {
+        // Items in rows below the canvas, so the webcam never touches them but they fill the index
+        for (; block_count < keep_out_count; block_count++) {
+            (void)ObsStub::add_item(scene, std::format("Block {}", block_count),
+                                    { 60.0f * static_cast<float>(block_count % 32),
+                                      2000.0f + 60.0f * static_cast<float>(block_count / 32) },
+                                    { 50.0f, 50.0f });
+        }
+        String command = R"(set_keep_out("")";
+        for (int i = 0; i < keep_out_count; i++) {
+            command += std::format(R"(, "Block {}")", i);
+        }
+        (void)handler.process_message(command + ")");
+        Bench::run_benchmark(std::format("video tick with velocity control, {} keep-out items", keep_out_count),
+                             1'000'000, [&] {
+            step = (step + 1) & 255;
+            CameraController::getInstance().set_velocity(step & 128 ? 300.0f : -300.0f, 0.0f);
+            run_frames(1);
+        });
+    }
+    (void)handler.process_message("set_velocity(0, 0)");
+    (void)handler.process_message("clear_constraints()");
+
+    std::printf("\nPosition subscriptions\n");
+    for (const auto& subscriber : subscribers) {
+        (void)handler.process_message("subscribe_position(1000)", { subscriber });
+    }
+    Bench::run_benchmark("video tick moving, 100 subscribers", 1'000'000, [&] {
+        step = (step + 1) & 255;
+        CameraController::getInstance().set_velocity(step & 128 ? 300.0f : -300.0f, 0.0f);
+        run_frames(1);
+    });
+    (void)handler.process_message("set_velocity(0, 0)");
+    Bench::run_benchmark("video tick standing still, 100 subscribers", 1'000'000, [] {
+        run_frames(1);
+    });
+
+    PositionPublisher::get_instance().stop();
+    MotionConstraints::get_instance().stop();
+    CameraController::getInstance().stop();
+    AnimationScheduler::get_instance().stop();
+    Logger::get_instance().shutdown();
+    ObsStub::reset();
+    return 0;
+}
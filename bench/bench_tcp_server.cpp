@@ -0,0 +1,105 @@
+// Throughput of TCPServer by number of I/O threads and concurrently connected clients, over loopback
+// against the libobs stand-in.
+#include "tcp_server.h"
+#include "camera_controller.h"
+#include "logger.h"
+#include "obs_stub.h"
+#include "bench_utils.h"
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace ObsCamMove;
+
+namespace {
+    constexpr auto RUN_TIME = std::chrono::milliseconds(500);
+    // Commands a client sends before it waits for their replies
+    constexpr usize PIPELINE_DEPTH = 16;
+
+    //! Sends pipelined batches of get_camera_position() until the deadline; returns the number of replies.
+    usize run_client(const uint16_t port, const std::chrono::steady_clock::time_point deadline) {
+        asio::io_context io_context;
+        asio::ip::tcp::socket socket(io_context);
+        socket.connect({ asio::ip::make_address("127.0.0.1"), port });
+        socket.set_option(asio::ip::tcp::no_delay(true));
+
+        String batch;
+        for (usize i = 0; i < PIPELINE_DEPTH; i++) {
+            batch += "get_camera_position()\n";
+        }
+
+        usize replies = 0;
+        String received;
+        char buffer[4096];
+        while (std::chrono::steady_clock::now() < deadline) {
+            asio::write(socket, asio::buffer(batch));
+
+            usize lines = 0;
+            while (lines < PIPELINE_DEPTH) {
+                const usize size = socket.read_some(asio::buffer(buffer));
+                for (usize i = 0; i < size; i++) {
+                    lines += buffer[i] == '\n';
+                }
+            }
+            replies += lines;
+        }
+
+        asio::error_code ec;
+        socket.shutdown(asio::ip::tcp::socket::shutdown_both, ec);
+        return replies;
+    }
+
+    double commands_per_second(const uint16_t port, const usize client_count) {
+        const auto deadline = std::chrono::steady_clock::now() + RUN_TIME;
+        std::vector<usize> replies(client_count);
+        std::vector<std::thread> clients;
+        for (usize i = 0; i < client_count; i++) {
+            clients.emplace_back([&, i] { replies[i] = run_client(port, deadline); });
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (auto& client : clients) {
+            client.join();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        usize total = 0;
+        for (const usize count : replies) total += count;
+        return static_cast<double>(total) / elapsed.count();
+    }
+}
+
+int main() {
+    Logger::get_instance().set_min_level(LogLevel::WARN);
+
+    obs_scene_t* scene = ObsStub::create_scene("Main");
+    ObsStub::add_item(scene, "Webcam", { 100.0f, 100.0f });
+    CameraController::getInstance().start();
+    CameraController::getInstance().set_camera_names({ "Webcam" });
+
+    std::printf("Commands per second (get_camera_position, %zu pipelined per client)\n", PIPELINE_DEPTH);
+    std::printf("%-16s", "clients");
+    for (const usize clients : { 1, 2, 4, 8, 16, 32 }) {
+        std::printf("%12zu", clients);
+    }
+    std::printf("\n");
+
+    for (const usize threads : { 1, 2, 4, 8 }) {
+        TCPServer server(0, FramingMode::Newline, threads);
+        server.start();
+
+        std::printf("%-16s", std::format("{} I/O thread(s)", threads).c_str());
+        for (const usize clients : { 1, 2, 4, 8, 16, 32 }) {
+            std::printf("%12.0f", commands_per_second(server.get_port(), clients));
+            std::fflush(stdout);
+        }
+        std::printf("\n");
+        server.stop();
+    }
+
+    CameraController::getInstance().stop();
+    Logger::get_instance().shutdown();
+    ObsStub::reset();
+    return 0;
+}
@@ -0,0 +1,180 @@
+// Round-trip latency of one command at a time over TCP loopback, a Unix domain socket and the shared
+// memory rings, against the libobs stand-in. All three feed the same MessageHandler, so the replies
+// are verified to be identical before timing.
+#include "tcp_server.h"
+#include "shared_memory_transport.h"
+#include "message_framer.h"
+#include "binary_protocol.h"
+#include "camera_controller.h"
+#include "metrics.h"
+#include "logger.h"
+#include "obs_stub.h"
+#include "bench_utils.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <unistd.h>
+
+using namespace ObsCamMove;
+
+namespace {
+    constexpr usize ROUND_TRIPS = 20000;
+    constexpr StringView COMMAND = "get_camera_position()";
+
+    //! Sends one command per round trip over a connected stream socket and reads its newline framed reply.
+    template<typename Socket>
+    class StreamClient {
+    public:
+        explicit StreamClient(Socket socket) : socket_(std::move(socket)) {
+            request_ = String(COMMAND) + "\n";
+        }
+
+        const String& request() {
+            asio::write(socket_, asio::buffer(request_));
+            reply_.clear();
+            while (true) {
+                const usize size = socket_.read_some(asio::buffer(buffer_));
+                reply_.append(buffer_, size);
+                if (reply_.ends_with('\n')) {
+                    reply_.pop_back();
+                    return reply_;
+                }
+            }
+        }
+
+    private:
+        Socket socket_;
+        String request_;
+        String reply_;
+        char buffer_[4096];
+    };
+
+    //! A ring whose length prefix or indices were broken by the other process is discarded, not read.
+    bool verify_corrupt_ring() {
+        SharedMemoryRing::Control control{};
+        alignas(8) char data[64] = {};
+        const SharedMemoryRing ring(&control, data, sizeof(data));
+
+        String message;
+        const u32 too_long = 1000;
+        std::memcpy(data, &too_long, sizeof(too_long));
+        control.write_index = 8;
+        const bool length_rejected = !ring.peek(message) && ring.empty();
+
+        control.write_index += 4096; // More than the capacity
+        const bool index_rejected = !ring.peek(message) && ring.empty();
+
+        const bool still_usable = ring.try_write("ping") && ring.try_read(message) && message == "ping";
+        return length_rejected && index_rejected && still_usable;
+    }
+
+    //! A length-prefixed message whose length has BINARY_PROTOCOL_MAGIC as low byte stays one message; only
+    //! Auto mode switches to the binary protocol on that byte.
+    bool verify_length_prefix_magic() {
+        constexpr u32 length = 203;
+        static_assert((length & 0xFF) == BINARY_PROTOCOL_MAGIC);
+        String stream(sizeof(length), '\0');
+        std::memcpy(stream.data(), &length, sizeof(length));
+        stream.append(length, 'x');
+
+        const auto feed = [&](MessageFramer& framer) {
+            const auto buffer = framer.prepare(stream.size());
+            std::memcpy(buffer.data(), stream.data(), stream.size());
+            framer.commit(stream.size());
+            return framer.next_message();
+        };
+
+        MessageFramer length_prefixed(FramingMode::LengthPrefixed);
+        const auto message = feed(length_prefixed);
+        MessageFramer automatic(FramingMode::Auto);
+        (void)feed(automatic);
+        return message && message->size() == length && length_prefixed.get_mode() == FramingMode::LengthPrefixed
+            && automatic.get_mode() == FramingMode::Binary;
+    }
+
+    //! Times ROUND_TRIPS requests and prints the mean and percentiles of the round trip.
+    void measure(const char* name, const std::function<const String&()>& request) {
+        for (usize i = 0; i < ROUND_TRIPS / 10; i++) {
+            Bench::do_not_optimize(request()); // Warm up
+        }
+
+        LatencyHistogram histogram;
+        const u64 start_ns = steady_clock_ns();
+        for (usize i = 0; i < ROUND_TRIPS; i++) {
+            const u64 sent_ns = steady_clock_ns();
+            Bench::do_not_optimize(request());
+            histogram.record(steady_clock_ns() - sent_ns);
+        }
+        const double mean_ns = static_cast<double>(steady_clock_ns() - start_ns) / static_cast<double>(ROUND_TRIPS);
+
+        const auto summary = histogram.summarize();
+        std::printf("%-24s %10.1f %10.1f %10.1f %10.1f\n", name, mean_ns / 1000.0, summary.p50 / 1000.0,
+                    summary.p99 / 1000.0, summary.max / 1000.0);
+    }
+}
+
+int main() {
+    Logger::get_instance().set_min_level(LogLevel::WARN);
+
+    obs_scene_t* scene = ObsStub::create_scene("Main");
+    ObsStub::add_item(scene, "Webcam", { 100.0f, 100.0f });
+    CameraController::getInstance().start();
+    CameraController::getInstance().set_camera_names({ "Webcam" });
+
+    const String socket_path = (std::filesystem::temp_directory_path()
+        / std::format("obs_camera_move_bench_{}.sock", getpid())).string();
+    const String shm_name = std::format("/obs_camera_move_bench_{}", getpid());
+
+    TCPServer server(0, FramingMode::Newline, 1, socket_path);
+    server.start();
+    SharedMemoryServer shared_memory_server(shm_name);
+    shared_memory_server.start();
+
+    asio::io_context io_context;
+    asio::ip::tcp::socket tcp_socket(io_context);
+    tcp_socket.connect({ asio::ip::make_address("127.0.0.1"), server.get_port() });
+    tcp_socket.set_option(asio::ip::tcp::no_delay(true));
+    StreamClient tcp_client(std::move(tcp_socket));
+
+    asio::local::stream_protocol::socket local_socket(io_context);
+    local_socket.connect(asio::local::stream_protocol::endpoint(socket_path));
+    StreamClient local_client(std::move(local_socket));
+
+    SharedMemoryClient shared_memory_client(shm_name);
+
+    // +++ Verification +++
+    const String expected = tcp_client.request();
+    bool ok = true;
+    if (const String& reply = local_client.request(); reply != expected) {
+        std::printf("Unix socket reply '%s' differs from TCP reply '%s'\n", reply.c_str(), expected.c_str());
+        ok = false;
+    }
+    if (const String& reply = shared_memory_client.request(COMMAND); reply != expected) {
+        std::printf("Shared memory reply '%s' differs from TCP reply '%s'\n", reply.c_str(), expected.c_str());
+        ok = false;
+    }
+    std::printf("Verify replies:        %s (%s)\n", ok ? "OK" : "FAILED", expected.c_str());
+    const bool corrupt_ok = verify_corrupt_ring();
+    std::printf("Verify corrupt ring:   %s\n", corrupt_ok ? "OK" : "FAILED");
+    ok &= corrupt_ok;
+    const bool framing_ok = verify_length_prefix_magic();
+    std::printf("Verify length prefix:  %s\n", framing_ok ? "OK" : "FAILED");
+    ok &= framing_ok;
+
+    // +++ Timing +++
+    std::printf("\nRound trip of %.*s, one at a time (%zu round trips)\n", static_cast<int>(COMMAND.size()),
+                COMMAND.data(), ROUND_TRIPS);
+    std::printf("%-24s %10s %10s %10s %10s\n", "transport", "mean us", "p50 us", "p99 us", "max us");
+    measure("TCP loopback", [&]() -> const String& { return tcp_client.request(); });
+    measure("Unix domain socket", [&]() -> const String& { return local_client.request(); });
+    measure("Shared memory ring", [&]() -> const String& { return shared_memory_client.request(COMMAND); });
+
+    shared_memory_server.stop();
+    server.stop();
+    CameraController::getInstance().stop();
+    Logger::get_instance().shutdown();
+    ObsStub::reset();
+    return ok ? 0 : 1;
+}
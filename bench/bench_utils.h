@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace ObsCamMove::Bench {
+    //! Number of heap allocations since program start (alloc_counter.cpp must be linked).
+    std::size_t allocation_count();
+
+    //! Keeps the compiler from optimizing away a value that is computed only for the benchmark.
+    template<typename T>
+    void do_not_optimize(const T& value) {
+#ifdef _MSC_VER
+        const volatile char sink = *reinterpret_cast<const volatile char*>(&value);
+        (void)sink;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+
+    //! Runs the function repeatedly and prints the average time and heap allocations per call.
+    template<typename Function>
+    double run_benchmark(const std::string& name, const std::size_t iterations, Function&& function) {
+        // Warm up caches and branch predictors
+        for (std::size_t i = 0; i < iterations / 10 + 1; i++) {
+            function();
+        }
+
+        const std::size_t allocations_before = allocation_count();
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; i++) {
+            function();
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        const std::size_t allocations = allocation_count() - allocations_before;
+
+        const double ns_per_op = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count())
+            / static_cast<double>(iterations);
+        const double allocations_per_op = static_cast<double>(allocations) / static_cast<double>(iterations);
+        std::printf("%-48s %12.1f ns/op %10.2f allocs/op\n", name.c_str(), ns_per_op, allocations_per_op);
+        return ns_per_op;
+    }
+}
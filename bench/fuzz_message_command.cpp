@@ -0,0 +1,30 @@
+// libFuzzer harness: differential test of MessageCommand against the original regex parser.
+// Seed corpus: bench/corpus/message_command
+#include "message_command.h"
+#include "message_command_reference.h"
+#include <cstdint>
+#include <cstdlib>
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, const std::size_t size) {
+    using namespace ObsCamMove;
+
+    const String message(reinterpret_cast<const char*>(data), size);
+    const MessageCommand command(message);
+    const Bench::ReferenceCommand reference(message);
+
+    if (command.is_valid() != reference.valid || command.get_command() != reference.command
+        || command.get_params().size() != reference.params.size()) {
+        std::abort();
+    }
+    for (usize i = 0; i < reference.params.size(); i++) {
+        if (command.get_params()[i] != reference.params[i]) {
+            std::abort();
+        }
+    }
+
+    int value = 0;
+    for (const auto param : command.get_params()) {
+        (void)parse_int(param, value);
+    }
+    return 0;
+}
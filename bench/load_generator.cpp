@@ -0,0 +1,401 @@
+// Load generator for the control protocol. Generates sessions or replays recorded ones (see
+// OBS_CAMERA_MOVE_RECORD) at 1x or Nx speed over many connections, against a running plugin or a server
+// started in-process on the libobs stand-in, and reports throughput, reply latency and errors.
+//
+//   load_generator generate <file> [--connections N] [--seconds S] [--rate HZ]
+//   load_generator replay <file> [--speed X] [--copies N] [--host HOST --port PORT] [--io-threads N]
+//                                [--record FILE]
+//
+// --speed 0 sends as fast as possible. Without --port the session is replayed against a local server,
+// which can record what it receives with --record.
+#include "tcp_server.h"
+#include "animation_scheduler.h"
+#include "camera_controller.h"
+#include "position_publisher.h"
+#include "binary_protocol.h"
+#include "session_recording.h"
+#include "metrics.h"
+#include "logger.h"
+#include "obs_stub.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <format>
+#include <map>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace ObsCamMove;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr auto REPLY_TIMEOUT = std::chrono::seconds(5);
+
+    struct Options {
+        String command;
+        String file;
+        String host = "127.0.0.1";
+        String record_file;
+        u16 port = 0;
+        double speed = 1.0;
+        usize copies = 1;
+        usize io_threads = 2;
+        usize connections = 4;
+        double seconds = 10.0;
+        double rate = 60.0;
+    };
+
+    struct ReplayStats {
+        LatencyHistogram latency;
+        std::atomic<u64> sent = 0;
+        std::atomic<u64> replies = 0;
+        std::atomic<u64> errors = 0;
+        std::atomic<u64> failed_connections = 0;
+    };
+
+    std::optional<Options> parse_options(const int argc, char* argv[]) {
+        if (argc < 3) {
+            return std::nullopt;
+        }
+
+        Options options;
+        options.command = argv[1];
+        options.file = argv[2];
+        for (int i = 3; i + 1 < argc; i += 2) {
+            const StringView name = argv[i];
+            const String value = argv[i + 1];
+            if (name == "--host") options.host = value;
+            else if (name == "--port") options.port = static_cast<u16>(std::stoi(value));
+            else if (name == "--speed") options.speed = std::stod(value);
+            else if (name == "--copies") options.copies = std::max(1, std::stoi(value));
+            else if (name == "--io-threads") options.io_threads = std::max(1, std::stoi(value));
+            else if (name == "--connections") options.connections = std::max(1, std::stoi(value));
+            else if (name == "--seconds") options.seconds = std::stod(value);
+            else if (name == "--rate") options.rate = std::stod(value);
+            else if (name == "--record") options.record_file = value;
+            else return std::nullopt;
+        }
+        return options;
+    }
+
+    //! A session of camera operators: each connection selects the webcam and then streams a mix of
+    //! queries, velocity updates and moves at the given rate.
+    std::vector<SessionRecord> generate_session(const Options& options) {
+        std::vector<SessionRecord> records;
+        for (u32 connection = 0; connection < options.connections; connection++) {
+            std::mt19937 random(42 + connection);
+            std::uniform_int_distribution<int> percent(0, 99);
+            std::uniform_int_distribution<int> coordinate(0, 1280);
+
+            records.push_back({ connection, 0, SessionMessageKind::Text, R"(set_camera_names("Webcam"))" });
+            const auto interval_us = static_cast<u64>(1e6 / options.rate);
+            for (u64 time_us = interval_us; time_us < static_cast<u64>(options.seconds * 1e6); time_us += interval_us) {
+                const int kind = percent(random);
+                String command;
+                if (kind < 50) command = "get_camera_position()";
+                else if (kind < 70) command = std::format("set_velocity({}, {})", coordinate(random) - 640, coordinate(random) / 4 - 160);
+                else if (kind < 90) command = std::format("move_to({}, {}, 500, 3)", coordinate(random), coordinate(random) / 2);
+                else command = "get_camera_name()";
+                records.push_back({ connection, time_us, SessionMessageKind::Text, std::move(command) });
+            }
+        }
+
+        std::ranges::stable_sort(records, {}, &SessionRecord::time_us);
+        return records;
+    }
+
+    //! Reads the replies of one connection and matches them in order with the send times.
+    class ReplyReader {
+    public:
+        ReplyReader(asio::ip::tcp::socket& socket, const bool binary, ReplayStats& stats)
+            : socket_(socket), binary_(binary), stats_(stats) {
+        }
+
+        void sent(const Clock::time_point time) {
+            std::lock_guard lock(mutex_);
+            send_times_.push_back(time);
+        }
+
+        //! Waits until all sent commands have their reply, or the timeout expired.
+        void wait_for_replies(const usize count) {
+            std::unique_lock lock(mutex_);
+            done_.wait_for(lock, REPLY_TIMEOUT, [&] { return received_ >= count; });
+        }
+
+        void run() {
+            String data;
+            char buffer[16 * 1024];
+            asio::error_code ec;
+            while (true) {
+                const usize size = socket_.read_some(asio::buffer(buffer), ec);
+                if (ec) {
+                    break;
+                }
+                data.append(buffer, size);
+                usize consumed = 0;
+                while (const auto reply = next_reply(StringView(data).substr(consumed))) {
+                    consumed += reply->size;
+                    complete(reply->error);
+                }
+                data.erase(0, consumed);
+            }
+        }
+
+    private:
+        struct Reply {
+            usize size;
+            bool error;
+        };
+
+        asio::ip::tcp::socket& socket_;
+        bool binary_;
+        ReplayStats& stats_;
+        std::mutex mutex_;
+        std::condition_variable done_;
+        std::deque<Clock::time_point> send_times_;
+        usize received_ = 0;
+
+        std::optional<Reply> next_reply(const StringView data) const {
+            if (binary_) {
+                if (data.size() < BINARY_REPLY_HEADER_SIZE) {
+                    return std::nullopt;
+                }
+                u32 length = 0;
+                for (int i = 0; i < 4; i++) {
+                    length |= static_cast<u32>(static_cast<u8>(data[4 + i])) << (8 * i);
+                }
+                if (data.size() < BINARY_REPLY_HEADER_SIZE + length) {
+                    return std::nullopt;
+                }
+                return Reply{ BINARY_REPLY_HEADER_SIZE + length, static_cast<u8>(data[1]) != 0 };
+            }
+
+            const usize end = data.find('\n');
+            if (end == StringView::npos) {
+                return std::nullopt;
+            }
+            const StringView line = data.substr(0, end);
+            return Reply{ end + 1, line.starts_with("ERROR") || line.starts_with("No response") };
+        }
+
+        void complete(const bool error) {
+            const auto now = Clock::now();
+            std::lock_guard lock(mutex_);
+            if (send_times_.empty()) {
+                return; // Not a reply to a replayed command
+            }
+            const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(now - send_times_.front());
+            send_times_.pop_front();
+            stats_.latency.record(static_cast<u64>(latency.count()));
+            stats_.replies.fetch_add(1, std::memory_order_relaxed);
+            if (error) {
+                stats_.errors.fetch_add(1, std::memory_order_relaxed);
+            }
+            received_++;
+            done_.notify_one();
+        }
+    };
+
+    //! Replays the messages of one recorded connection on a new connection to the server.
+    void replay_connection(const asio::ip::tcp::endpoint& endpoint, const std::vector<const SessionRecord*>& records,
+                           const double speed, const Clock::time_point start, ReplayStats& stats) {
+        asio::io_context io_context;
+        asio::ip::tcp::socket socket(io_context);
+        asio::error_code ec;
+        socket.connect(endpoint, ec);
+        if (ec) {
+            stats.failed_connections.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        socket.set_option(asio::ip::tcp::no_delay(true));
+
+        const bool binary = !records.empty() && records.front()->kind == SessionMessageKind::Binary;
+        ReplyReader reader(socket, binary, stats);
+        std::thread reader_thread([&] { reader.run(); });
+
+        if (binary) {
+            const char magic = static_cast<char>(BINARY_PROTOCOL_MAGIC);
+            asio::write(socket, asio::buffer(&magic, 1), ec);
+        }
+
+        std::this_thread::sleep_until(start);
+        String message;
+        usize sent = 0;
+        for (const SessionRecord* record : records) {
+            if (ec) {
+                break;
+            }
+            if (speed > 0.0) {
+                std::this_thread::sleep_until(start + std::chrono::microseconds(
+                    static_cast<u64>(static_cast<double>(record->time_us) / speed)));
+            }
+
+            message = record->payload;
+            if (record->kind == SessionMessageKind::Text) {
+                message.push_back('\n');
+            }
+            reader.sent(Clock::now());
+            asio::write(socket, asio::buffer(message), ec);
+            sent++;
+        }
+        stats.sent.fetch_add(sent, std::memory_order_relaxed);
+
+        reader.wait_for_replies(sent);
+        socket.shutdown(asio::ip::tcp::socket::shutdown_both, ec);
+        socket.close(ec);
+        reader_thread.join();
+    }
+
+    //! TCPServer with the animation scheduler and camera controller on the libobs stand-in, ticked at 60 fps.
+    class LocalInstance {
+    public:
+        LocalInstance(const std::vector<SessionRecord>& records, const usize io_threads, const String& record_file) {
+            Logger::get_instance().set_min_level(LogLevel::ERROR);
+            if (!record_file.empty()) {
+                SessionRecorder::get_instance().start(record_file);
+            }
+
+            // Every quoted name of the session becomes a scene item, so recorded camera and item names resolve
+            std::set<String> names = { "Webcam" };
+            for (const auto& record : records) {
+                if (record.kind != SessionMessageKind::Text) continue;
+                for (usize begin = record.payload.find('"'); begin != String::npos;) {
+                    const usize end = record.payload.find('"', begin + 1);
+                    if (end == String::npos) break;
+                    names.insert(record.payload.substr(begin + 1, end - begin - 1));
+                    begin = record.payload.find('"', end + 1);
+                }
+            }
+            obs_scene_t* scene = ObsStub::create_scene("Main");
+            for (const auto& name : names) {
+                ObsStub::add_item(scene, name);
+            }
+
+            AnimationScheduler::get_instance().start();
+            CameraController::getInstance().start();
+            CameraController::getInstance().set_camera_names({ "Webcam" });
+            PositionPublisher::get_instance().start();
+
+            server_ = std::make_unique<TCPServer>(0, FramingMode::Auto, io_threads);
+            server_->start();
+            ticker_ = std::thread([this] {
+                auto next_frame = Clock::now();
+                while (running_.load(std::memory_order_relaxed)) {
+                    next_frame += std::chrono::nanoseconds(16'666'667);
+                    std::this_thread::sleep_until(next_frame);
+                    ObsStub::video_tick(steady_clock_ns());
+                }
+            });
+        }
+
+        ~LocalInstance() {
+            server_->stop();
+            SessionRecorder::get_instance().stop();
+            running_.store(false, std::memory_order_relaxed);
+            ticker_.join();
+            PositionPublisher::get_instance().stop();
+            CameraController::getInstance().stop();
+            AnimationScheduler::get_instance().stop();
+            Logger::get_instance().shutdown();
+            ObsStub::reset();
+        }
+
+        [[nodiscard]] u16 get_port() const { return server_->get_port(); }
+
+    private:
+        std::unique_ptr<TCPServer> server_;
+        std::atomic_bool running_ = true;
+        std::thread ticker_;
+    };
+
+    int replay(const Options& options) {
+        String error;
+        const auto records = read_session(options.file, error);
+        if (!records) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+
+        // Pushed position updates are no replies, so subscriptions can not be matched and are skipped
+        std::map<u32, std::vector<const SessionRecord*>> connections;
+        usize skipped = 0;
+        for (const auto& record : *records) {
+            if (record.kind == SessionMessageKind::Text && record.payload.starts_with("subscribe_position")) {
+                skipped++;
+                continue;
+            }
+            connections[record.connection].push_back(&record);
+        }
+
+        std::unique_ptr<LocalInstance> local;
+        if (options.port == 0) {
+            local = std::make_unique<LocalInstance>(*records, options.io_threads, options.record_file);
+        }
+        const asio::ip::tcp::endpoint endpoint(asio::ip::make_address(options.host),
+                                               local ? local->get_port() : options.port);
+
+        ReplayStats stats;
+        std::vector<std::thread> threads;
+        const auto start = Clock::now() + std::chrono::milliseconds(100); // Lets all connections connect first
+        for (usize copy = 0; copy < options.copies; copy++) {
+            for (const auto& [connection, connection_records] : connections) {
+                threads.emplace_back([&, &records = connection_records] {
+                    replay_connection(endpoint, records, options.speed, start, stats);
+                });
+            }
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+        local.reset();
+
+        const auto latency = stats.latency.summarize();
+        const u64 sent = stats.sent.load();
+        const u64 replies = stats.replies.load();
+        std::printf("Replayed %llu commands on %zu connections in %.2f s (speed %s)\n",
+                    static_cast<unsigned long long>(sent), threads.size(), elapsed.count(),
+                    options.speed > 0.0 ? std::format("{}x", options.speed).c_str() : "unlimited");
+        std::printf("%-20s %.0f replies/s\n", "Throughput", static_cast<double>(replies) / elapsed.count());
+        std::printf("%-20s p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n", "Reply latency",
+                    static_cast<double>(latency.p50) / 1e6, static_cast<double>(latency.p95) / 1e6,
+                    static_cast<double>(latency.p99) / 1e6, static_cast<double>(latency.max) / 1e6);
+        std::printf("%-20s %llu error replies, %llu without reply, %llu connections failed\n", "Errors",
+                    static_cast<unsigned long long>(stats.errors.load()),
+                    static_cast<unsigned long long>(sent - replies),
+                    static_cast<unsigned long long>(stats.failed_connections.load()));
+        if (skipped > 0) {
+            std::printf("%-20s %zu subscribe_position commands\n", "Skipped", skipped);
+        }
+        return stats.errors.load() == 0 && sent == replies && stats.failed_connections.load() == 0 ? 0 : 2;
+    }
+}
+
+int main(const int argc, char* argv[]) {
+    const auto options = parse_options(argc, argv);
+    if (!options || (options->command != "generate" && options->command != "replay")) {
+        std::fprintf(stderr,
+            "Usage: load_generator generate <file> [--connections N] [--seconds S] [--rate HZ]\n"
+            "       load_generator replay <file> [--speed X] [--copies N] [--host HOST --port PORT] [--io-threads N]\n"
+            "                             [--record FILE]\n");
+        return 1;
+    }
+
+    if (options->command == "generate") {
+        String error;
+        const auto records = generate_session(*options);
+        if (!write_session(options->file, records, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        std::printf("Wrote %zu commands on %zu connections to %s\n", records.size(), options->connections,
+                    options->file.c_str());
+        return 0;
+    }
+    return replay(*options);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "prerequisites.h"
+#include "string_utils.h"
+#include <regex>
+#include <sstream>
+#include <vector>
+
+namespace ObsCamMove::Bench {
+    //! The original regex based MessageCommand parser, kept as reference for the benchmark and fuzzer.
+    struct ReferenceCommand {
+        bool valid = false;
+        String command;
+        std::vector<String> params;
+
+        explicit ReferenceCommand(const String& message) {
+            static const std::regex COMMAND_REGEX(R"(^(\w+)\(([^)]*)\);?$)");
+            if (std::smatch match; std::regex_match(message, match, COMMAND_REGEX)) {
+                valid = true;
+                command = match[1];
+                const String param_list = match[2];
+
+                std::istringstream param_stream(param_list);
+                String param;
+                while (std::getline(param_stream, param, ',')) {
+                    params.push_back(trim(param));
+                }
+            }
+        }
+    };
+}
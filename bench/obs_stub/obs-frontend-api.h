@@ -0,0 +1,34 @@
+#pragma once
+
+// Stand-in for the parts of the OBS frontend API used by the plugin.
+#include "obs.h"
+
+enum obs_frontend_event {
+    OBS_FRONTEND_EVENT_STREAMING_STARTING,
+    OBS_FRONTEND_EVENT_STREAMING_STARTED,
+    OBS_FRONTEND_EVENT_STREAMING_STOPPING,
+    OBS_FRONTEND_EVENT_STREAMING_STOPPED,
+    OBS_FRONTEND_EVENT_RECORDING_STARTING,
+    OBS_FRONTEND_EVENT_RECORDING_STARTED,
+    OBS_FRONTEND_EVENT_RECORDING_STOPPING,
+    OBS_FRONTEND_EVENT_RECORDING_STOPPED,
+    OBS_FRONTEND_EVENT_SCENE_CHANGED,
+    OBS_FRONTEND_EVENT_SCENE_LIST_CHANGED,
+    OBS_FRONTEND_EVENT_TRANSITION_CHANGED,
+    OBS_FRONTEND_EVENT_TRANSITION_STOPPED,
+    OBS_FRONTEND_EVENT_TRANSITION_LIST_CHANGED,
+    OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED,
+    OBS_FRONTEND_EVENT_SCENE_COLLECTION_LIST_CHANGED,
+    OBS_FRONTEND_EVENT_PROFILE_CHANGED,
+    OBS_FRONTEND_EVENT_PROFILE_LIST_CHANGED,
+    OBS_FRONTEND_EVENT_EXIT,
+    OBS_FRONTEND_EVENT_SCENE_COLLECTION_CLEANUP = 26,
+};
+
+typedef void (*obs_frontend_event_cb)(enum obs_frontend_event event, void* private_data);
+
+extern "C" {
+    obs_source_t* obs_frontend_get_current_scene(void);
+    void obs_frontend_add_event_callback(obs_frontend_event_cb callback, void* private_data);
+    void obs_frontend_remove_event_callback(obs_frontend_event_cb callback, void* private_data);
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+// Stand-in for obs-module.h; the module entry points are not part of the benchmarks.
+#include "obs.h"
@@ -0,0 +1,109 @@
+#pragma once
+
+// Stand-in for the parts of libobs used by the plugin, so the benchmarks build and run without OBS.
+// Declarations match the real obs.h; the implementations are in obs_stub.cpp.
+
+#include <cstdint>
+
+struct vec2 {
+    float x, y;
+};
+
+typedef struct obs_source obs_source_t;
+typedef struct obs_scene obs_scene_t;
+typedef struct obs_scene_item obs_sceneitem_t;
+typedef struct signal_handler signal_handler_t;
+typedef struct calldata calldata_t;
+typedef struct obs_data obs_data_t;
+
+typedef void (*signal_callback_t)(void* data, calldata_t* params);
+
+enum obs_bounds_type {
+    OBS_BOUNDS_NONE,
+};
+
+struct obs_transform_info {
+    struct vec2 pos;
+    float rot;
+    struct vec2 scale;
+    uint32_t alignment;
+    enum obs_bounds_type bounds_type;
+    uint32_t bounds_alignment;
+    struct vec2 bounds;
+    bool crop_to_bounds;
+};
+
+struct obs_sceneitem_crop {
+    int left;
+    int top;
+    int right;
+    int bottom;
+};
+
+// Only the fields the plugin reads
+struct obs_video_info {
+    uint32_t fps_num;
+    uint32_t fps_den;
+};
+
+enum {
+    LOG_ERROR = 100,
+    LOG_WARNING = 200,
+    LOG_INFO = 300,
+    LOG_DEBUG = 400,
+};
+
+extern "C" {
+    void blog(int log_level, const char* format, ...);
+
+    void obs_add_tick_callback(void (*tick)(void* param, float seconds), void* param);
+    void obs_remove_tick_callback(void (*tick)(void* param, float seconds), void* param);
+    uint64_t obs_get_video_frame_time(void);
+    bool obs_get_video_info(struct obs_video_info* ovi);
+
+    signal_handler_t* obs_get_signal_handler(void);
+    void signal_handler_connect(signal_handler_t* handler, const char* signal, signal_callback_t callback, void* data);
+    void signal_handler_disconnect(signal_handler_t* handler, const char* signal, signal_callback_t callback, void* data);
+    void* calldata_ptr(const calldata_t* data, const char* name);
+
+    obs_source_t* obs_source_get_ref(obs_source_t* source);
+    void obs_source_release(obs_source_t* source);
+    const char* obs_source_get_name(const obs_source_t* source);
+    uint32_t obs_source_get_width(obs_source_t* source);
+    uint32_t obs_source_get_height(obs_source_t* source);
+    signal_handler_t* obs_source_get_signal_handler(const obs_source_t* source);
+    obs_source_t* obs_source_create_private(const char* id, const char* name, obs_data_t* settings);
+    obs_source_t* obs_source_get_filter_by_name(obs_source_t* source, const char* name);
+    void obs_source_filter_add(obs_source_t* source, obs_source_t* filter);
+    obs_data_t* obs_source_get_settings(const obs_source_t* source);
+    void obs_source_update(obs_source_t* source, obs_data_t* settings);
+
+    obs_data_t* obs_data_create(void);
+    void obs_data_addref(obs_data_t* data);
+    void obs_data_release(obs_data_t* data);
+    void obs_data_set_double(obs_data_t* data, const char* name, double val);
+    double obs_data_get_double(obs_data_t* data, const char* name);
+
+    obs_scene_t* obs_scene_from_source(const obs_source_t* source);
+    obs_source_t* obs_scene_get_source(const obs_scene_t* scene);
+    obs_sceneitem_t* obs_scene_find_source(obs_scene_t* scene, const char* name);
+    void obs_enum_scenes(bool (*enum_proc)(void* param, obs_source_t* source), void* param);
+    void obs_scene_enum_items(obs_scene_t* scene, bool (*callback)(obs_scene_t* scene, obs_sceneitem_t* item, void* param),
+                              void* param);
+
+    void obs_sceneitem_addref(obs_sceneitem_t* item);
+    void obs_sceneitem_release(obs_sceneitem_t* item);
+    obs_scene_t* obs_sceneitem_get_scene(const obs_sceneitem_t* item);
+    obs_source_t* obs_sceneitem_get_source(const obs_sceneitem_t* item);
+    void obs_sceneitem_get_pos(const obs_sceneitem_t* item, struct vec2* pos);
+    void obs_sceneitem_set_pos(obs_sceneitem_t* item, const struct vec2* pos);
+    void obs_sceneitem_get_scale(const obs_sceneitem_t* item, struct vec2* scale);
+    void obs_sceneitem_set_scale(obs_sceneitem_t* item, const struct vec2* scale);
+    float obs_sceneitem_get_rot(const obs_sceneitem_t* item);
+    void obs_sceneitem_set_rot(obs_sceneitem_t* item, float rot_deg);
+    void obs_sceneitem_get_crop(const obs_sceneitem_t* item, struct obs_sceneitem_crop* crop);
+    void obs_sceneitem_set_crop(obs_sceneitem_t* item, const struct obs_sceneitem_crop* crop);
+    void obs_sceneitem_defer_update_begin(obs_sceneitem_t* item);
+    void obs_sceneitem_defer_update_end(obs_sceneitem_t* item);
+    void obs_sceneitem_get_info2(const obs_sceneitem_t* item, struct obs_transform_info* info);
+}
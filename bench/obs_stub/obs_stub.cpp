@@ -0,0 +1,527 @@
+#include "obs_stub.h"
+#include "util/platform.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct signal_handler {
+    struct Connection {
+        std::string signal;
+        signal_callback_t callback;
+        void* data;
+    };
+
+    std::mutex mutex;
+    std::vector<Connection> connections;
+
+    void emit(const std::string_view signal, calldata_t* params = nullptr) {
+        // Reused per thread, so emitting does not allocate once warm; nested emits get their own list
+        thread_local std::vector<std::vector<Connection>> target_lists;
+        thread_local std::size_t depth = 0;
+        if (target_lists.size() <= depth) target_lists.resize(depth + 1);
+        auto targets = std::move(target_lists[depth]);
+        targets.clear();
+        {
+            std::lock_guard lock(mutex);
+            for (const auto& connection : connections) {
+                if (connection.signal == signal) targets.push_back(connection);
+            }
+        }
+        depth++;
+        for (const auto& target : targets) {
+            target.callback(target.data, params);
+        }
+        depth--;
+        target_lists[depth] = std::move(targets);
+    }
+};
+
+// Only the parameter the plugin reads: the scene item of the item signals
+struct calldata {
+    obs_sceneitem_t* item = nullptr;
+};
+
+struct obs_data {
+    std::atomic<long> refs = 1;
+    std::map<std::string, double, std::less<>> doubles;
+};
+
+struct obs_source {
+    std::string name;
+    std::atomic<long> refs = 1;
+    signal_handler signals;
+    obs_scene* scene = nullptr;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<obs_source*> filters;
+    std::map<std::string, double, std::less<>> settings;
+};
+
+struct obs_scene_item {
+    obs_scene* parent = nullptr;
+    obs_source* source = nullptr;
+    vec2 pos = {};
+    vec2 scale = { 1.0f, 1.0f };
+    float rot = 0.0f;
+    obs_sceneitem_crop crop = {};
+    std::atomic<long> refs = 1;
+    int defer_update = 0;
+};
+
+struct obs_scene {
+    obs_source* source = nullptr;
+    std::vector<obs_scene_item*> items;
+};
+
+namespace {
+    using namespace ObsCamMove;
+
+    struct TickCallback {
+        void (*tick)(void* param, float seconds);
+        void* param;
+    };
+
+    struct FrontendCallback {
+        obs_frontend_event_cb callback;
+        void* data;
+    };
+
+    // Objects are owned here rather than freed on their last release, so a reference counting
+    // mistake in the plugin cannot crash a benchmark run
+    struct StubState {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<obs_source>> sources;
+        std::vector<std::unique_ptr<obs_scene>> scenes;
+        std::vector<std::unique_ptr<obs_scene_item>> items;
+        std::vector<std::unique_ptr<obs_data>> data;
+        obs_scene* current_scene = nullptr;
+
+        // Held while the callbacks run (like in OBS), so dispatching them does not copy the lists
+        std::mutex tick_mutex;
+        std::vector<TickCallback> tick_callbacks;
+        std::mutex frontend_mutex;
+        std::vector<FrontendCallback> frontend_callbacks;
+        signal_handler global_signals;
+
+        std::atomic<u64> frame_time_ns = 0;
+        std::atomic<usize> scene_searches = 0;
+        std::atomic<usize> source_updates = 0;
+    };
+
+    StubState& state() {
+        static StubState instance;
+        return instance;
+    }
+
+    // Like OBS, every change of an item's transform is signalled on its scene
+    void emit_transform(obs_scene_item* item) {
+        if (item->parent != nullptr) {
+            calldata params{ item };
+            item->parent->source->signals.emit("item_transform", &params);
+        }
+    }
+
+    obs_source* create_source(const StringView name) {
+        auto& stub = state();
+        auto source = std::make_unique<obs_source>();
+        source->name = String(name);
+
+        std::lock_guard lock(stub.mutex);
+        return stub.sources.emplace_back(std::move(source)).get();
+    }
+}
+
+namespace ObsCamMove::ObsStub {
+    obs_scene_t* create_scene(const StringView name) {
+        auto& stub = state();
+        obs_source* source = create_source(name);
+        auto scene = std::make_unique<obs_scene>();
+        scene->source = source;
+        source->scene = scene.get();
+
+        std::lock_guard lock(stub.mutex);
+        obs_scene* result = stub.scenes.emplace_back(std::move(scene)).get();
+        if (stub.current_scene == nullptr) {
+            stub.current_scene = result;
+        }
+        return result;
+    }
+
+    obs_sceneitem_t* add_item(obs_scene_t* scene, const StringView source_name, const vec2 pos, const vec2 size) {
+        auto& stub = state();
+        auto item = std::make_unique<obs_scene_item>();
+        item->parent = scene;
+        item->source = create_source(source_name);
+        item->source->width = static_cast<uint32_t>(size.x);
+        item->source->height = static_cast<uint32_t>(size.y);
+        item->pos = pos;
+
+        obs_scene_item* result;
+        {
+            std::lock_guard lock(stub.mutex);
+            result = stub.items.emplace_back(std::move(item)).get();
+            scene->items.push_back(result);
+        }
+        calldata params{ result };
+        scene->source->signals.emit("item_add", &params);
+        return result;
+    }
+
+    obs_sceneitem_t* add_shared_item(obs_scene_t* scene, obs_sceneitem_t* item) {
+        auto& stub = state();
+        auto shared = std::make_unique<obs_scene_item>();
+        shared->parent = scene;
+        shared->source = item->source;
+
+        obs_scene_item* result;
+        {
+            std::lock_guard lock(stub.mutex);
+            result = stub.items.emplace_back(std::move(shared)).get();
+            scene->items.push_back(result);
+        }
+        calldata params{ result };
+        scene->source->signals.emit("item_add", &params);
+        return result;
+    }
+
+    void remove_item(obs_sceneitem_t* item) {
+        auto& stub = state();
+        obs_scene* scene = item->parent;
+        {
+            std::lock_guard lock(stub.mutex);
+            std::erase(scene->items, item);
+        }
+        calldata params{ item };
+        scene->source->signals.emit("item_remove", &params);
+    }
+
+    void set_current_scene(obs_scene_t* scene) {
+        {
+            std::lock_guard lock(state().mutex);
+            state().current_scene = scene;
+        }
+        send_frontend_event(OBS_FRONTEND_EVENT_SCENE_CHANGED);
+    }
+
+    void send_frontend_event(const obs_frontend_event event) {
+        std::lock_guard lock(state().frontend_mutex);
+        for (const auto& [callback, data] : state().frontend_callbacks) {
+            callback(event, data);
+        }
+    }
+
+    void video_tick(const u64 frame_time_ns) {
+        state().frame_time_ns.store(frame_time_ns, std::memory_order_relaxed);
+        std::lock_guard lock(state().tick_mutex);
+        for (const auto& [tick, param] : state().tick_callbacks) {
+            tick(param, 1.0f / 60.0f);
+        }
+    }
+
+    usize scene_search_count() {
+        return state().scene_searches.load(std::memory_order_relaxed);
+    }
+
+    usize source_update_count() {
+        return state().source_updates.load(std::memory_order_relaxed);
+    }
+
+    void reset() {
+        auto& stub = state();
+        std::lock_guard lock(stub.mutex);
+        stub.current_scene = nullptr;
+        stub.items.clear();
+        stub.data.clear();
+        stub.scenes.clear();
+        stub.sources.clear();
+    }
+}
+
+extern "C" {
+    void blog(const int log_level, const char* format, ...) {
+        // Only warnings and errors are printed, so benchmark output stays readable
+        if (log_level > LOG_WARNING) {
+            return;
+        }
+        va_list args;
+        va_start(args, format);
+        std::vfprintf(stderr, format, args);
+        va_end(args);
+        std::fputc('\n', stderr);
+    }
+
+    void obs_add_tick_callback(void (*tick)(void* param, float seconds), void* param) {
+        std::lock_guard lock(state().tick_mutex);
+        state().tick_callbacks.push_back({ tick, param });
+    }
+
+    void obs_remove_tick_callback(void (*tick)(void* param, float seconds), void* param) {
+        std::lock_guard lock(state().tick_mutex);
+        std::erase_if(state().tick_callbacks, [&](const TickCallback& callback) {
+            return callback.tick == tick && callback.param == param;
+        });
+    }
+
+    uint64_t obs_get_video_frame_time(void) {
+        return state().frame_time_ns.load(std::memory_order_relaxed);
+    }
+
+    // The benches tick at 60 fps
+    bool obs_get_video_info(struct obs_video_info* ovi) {
+        ovi->fps_num = 60;
+        ovi->fps_den = 1;
+        return true;
+    }
+
+    // The stand-in clock is the time of the last frame, so the scheduled frames are never late
+    uint64_t os_gettime_ns(void) {
+        return state().frame_time_ns.load(std::memory_order_relaxed);
+    }
+
+    signal_handler_t* obs_get_signal_handler(void) {
+        return &state().global_signals;
+    }
+
+    void signal_handler_connect(signal_handler_t* handler, const char* signal, const signal_callback_t callback,
+                                void* data) {
+        std::lock_guard lock(handler->mutex);
+        handler->connections.push_back({ signal, callback, data });
+    }
+
+    void signal_handler_disconnect(signal_handler_t* handler, const char* signal, const signal_callback_t callback,
+                                   void* data) {
+        std::lock_guard lock(handler->mutex);
+        // Like libobs, a disconnect removes a single matching connection
+        const auto it = std::ranges::find_if(handler->connections, [&](const signal_handler::Connection& connection) {
+            return connection.signal == signal && connection.callback == callback && connection.data == data;
+        });
+        if (it != handler->connections.end()) {
+            handler->connections.erase(it);
+        }
+    }
+
+    void* calldata_ptr(const calldata_t* data, const char* name) {
+        return data && std::string_view(name) == "item" ? data->item : nullptr;
+    }
+
+    obs_source_t* obs_source_get_ref(obs_source_t* source) {
+        if (source) source->refs.fetch_add(1, std::memory_order_relaxed);
+        return source;
+    }
+
+    void obs_source_release(obs_source_t* source) {
+        if (source) source->refs.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    const char* obs_source_get_name(const obs_source_t* source) {
+        return source ? source->name.c_str() : nullptr;
+    }
+
+    uint32_t obs_source_get_width(obs_source_t* source) {
+        return source ? source->width : 0;
+    }
+
+    uint32_t obs_source_get_height(obs_source_t* source) {
+        return source ? source->height : 0;
+    }
+
+    signal_handler_t* obs_source_get_signal_handler(const obs_source_t* source) {
+        return source ? &const_cast<obs_source_t*>(source)->signals : nullptr;
+    }
+
+    obs_source_t* obs_source_create_private(const char*, const char* name, obs_data_t* settings) {
+        obs_source* source = create_source(name ? name : "");
+        if (settings) source->settings = settings->doubles;
+        return source;
+    }
+
+    obs_source_t* obs_source_get_filter_by_name(obs_source_t* source, const char* name) {
+        std::lock_guard lock(state().mutex);
+        for (obs_source* filter : source->filters) {
+            if (filter->name == name) {
+                return obs_source_get_ref(filter);
+            }
+        }
+        return nullptr;
+    }
+
+    void obs_source_filter_add(obs_source_t* source, obs_source_t* filter) {
+        std::lock_guard lock(state().mutex);
+        source->filters.push_back(filter);
+    }
+
+    obs_data_t* obs_source_get_settings(const obs_source_t* source) {
+        obs_data_t* data = obs_data_create();
+        std::lock_guard lock(state().mutex);
+        data->doubles = source->settings;
+        return data;
+    }
+
+    void obs_source_update(obs_source_t* source, obs_data_t* settings) {
+        state().source_updates.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard lock(state().mutex);
+        for (const auto& [name, value] : settings->doubles) {
+            source->settings[name] = value;
+        }
+    }
+
+    obs_data_t* obs_data_create(void) {
+        auto& stub = state();
+        auto data = std::make_unique<obs_data>();
+        std::lock_guard lock(stub.mutex);
+        return stub.data.emplace_back(std::move(data)).get();
+    }
+
+    void obs_data_addref(obs_data_t* data) {
+        if (data) data->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void obs_data_release(obs_data_t* data) {
+        if (data) data->refs.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void obs_data_set_double(obs_data_t* data, const char* name, const double val) {
+        data->doubles[name] = val;
+    }
+
+    double obs_data_get_double(obs_data_t* data, const char* name) {
+        const auto it = data->doubles.find(std::string_view(name));
+        return it != data->doubles.end() ? it->second : 0.0;
+    }
+
+    obs_scene_t* obs_scene_from_source(const obs_source_t* source) {
+        return source ? source->scene : nullptr;
+    }
+
+    obs_source_t* obs_scene_get_source(const obs_scene_t* scene) {
+        return scene ? scene->source : nullptr;
+    }
+
+    obs_sceneitem_t* obs_scene_find_source(obs_scene_t* scene, const char* name) {
+        state().scene_searches.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard lock(state().mutex);
+        for (obs_scene_item* item : scene->items) {
+            if (item->source->name == name) {
+                return item;
+            }
+        }
+        return nullptr;
+    }
+
+    void obs_enum_scenes(bool (*enum_proc)(void* param, obs_source_t* source), void* param) {
+        std::vector<obs_source*> sources;
+        {
+            std::lock_guard lock(state().mutex);
+            for (const auto& scene : state().scenes) {
+                sources.push_back(scene->source);
+            }
+        }
+        for (obs_source* source : sources) {
+            if (!enum_proc(param, source)) {
+                return;
+            }
+        }
+    }
+
+    void obs_scene_enum_items(obs_scene_t* scene, bool (*callback)(obs_scene_t* scene, obs_sceneitem_t* item, void* param),
+                              void* param) {
+        std::vector<obs_scene_item*> items;
+        {
+            std::lock_guard lock(state().mutex);
+            items = scene->items;
+        }
+        for (obs_scene_item* item : items) {
+            if (!callback(scene, item, param)) {
+                return;
+            }
+        }
+    }
+
+    void obs_sceneitem_addref(obs_sceneitem_t* item) {
+        if (item) item->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void obs_sceneitem_release(obs_sceneitem_t* item) {
+        if (item) item->refs.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    obs_scene_t* obs_sceneitem_get_scene(const obs_sceneitem_t* item) {
+        return item ? item->parent : nullptr;
+    }
+
+    obs_source_t* obs_sceneitem_get_source(const obs_sceneitem_t* item) {
+        return item ? item->source : nullptr;
+    }
+
+    void obs_sceneitem_get_pos(const obs_sceneitem_t* item, vec2* pos) {
+        *pos = item->pos;
+    }
+
+    void obs_sceneitem_set_pos(obs_sceneitem_t* item, const vec2* pos) {
+        item->pos = *pos;
+        emit_transform(item);
+    }
+
+    void obs_sceneitem_get_scale(const obs_sceneitem_t* item, vec2* scale) {
+        *scale = item->scale;
+    }
+
+    void obs_sceneitem_set_scale(obs_sceneitem_t* item, const vec2* scale) {
+        item->scale = *scale;
+        emit_transform(item);
+    }
+
+    float obs_sceneitem_get_rot(const obs_sceneitem_t* item) {
+        return item->rot;
+    }
+
+    void obs_sceneitem_set_rot(obs_sceneitem_t* item, const float rot_deg) {
+        item->rot = rot_deg;
+    }
+
+    void obs_sceneitem_get_crop(const obs_sceneitem_t* item, obs_sceneitem_crop* crop) {
+        *crop = item->crop;
+    }
+
+    void obs_sceneitem_set_crop(obs_sceneitem_t* item, const obs_sceneitem_crop* crop) {
+        item->crop = *crop;
+    }
+
+    void obs_sceneitem_defer_update_begin(obs_sceneitem_t* item) {
+        item->defer_update++;
+    }
+
+    void obs_sceneitem_defer_update_end(obs_sceneitem_t* item) {
+        item->defer_update--;
+    }
+
+    void obs_sceneitem_get_info2(const obs_sceneitem_t* item, obs_transform_info* info) {
+        *info = {};
+        info->pos = item->pos;
+        info->rot = item->rot;
+        info->scale = item->scale;
+    }
+
+    obs_source_t* obs_frontend_get_current_scene(void) {
+        std::lock_guard lock(state().mutex);
+        obs_scene* scene = state().current_scene;
+        return scene ? obs_source_get_ref(scene->source) : nullptr;
+    }
+
+    void obs_frontend_add_event_callback(const obs_frontend_event_cb callback, void* private_data) {
+        std::lock_guard lock(state().frontend_mutex);
+        state().frontend_callbacks.push_back({ callback, private_data });
+    }
+
+    void obs_frontend_remove_event_callback(const obs_frontend_event_cb callback, void* private_data) {
+        std::lock_guard lock(state().frontend_mutex);
+        std::erase_if(state().frontend_callbacks, [&](const FrontendCallback& entry) {
+            return entry.callback == callback && entry.data == private_data;
+        });
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "prerequisites.h"
+#include <obs.h>
+#include <obs-frontend-api.h>
+
+// Controls the in-process libobs stand-in: builds scenes and drives the video tick and frontend events
+// that OBS would otherwise generate.
+namespace ObsCamMove::ObsStub {
+    //! Creates a scene; the first scene created becomes the current scene.
+    obs_scene_t* create_scene(StringView name);
+    //! Adds a new source with the given name and size to the scene and emits item_add.
+    obs_sceneitem_t* add_item(obs_scene_t* scene, StringView source_name, vec2 pos = {}, vec2 size = {});
+    //! Adds another item showing the source of item to the scene, like a second use of a webcam.
+    obs_sceneitem_t* add_shared_item(obs_scene_t* scene, obs_sceneitem_t* item);
+    //! Removes the item from its scene and emits item_remove. The item stays allocated until reset().
+    void remove_item(obs_sceneitem_t* item);
+
+    //! Makes the scene current and sends OBS_FRONTEND_EVENT_SCENE_CHANGED.
+    void set_current_scene(obs_scene_t* scene);
+    void send_frontend_event(obs_frontend_event event);
+
+    //! Runs all tick callbacks for a frame rendered at frame_time_ns.
+    void video_tick(u64 frame_time_ns);
+
+    //! Number of obs_scene_find_source calls so far.
+    [[nodiscard]] usize scene_search_count();
+    //! Number of obs_source_update calls so far.
+    [[nodiscard]] usize source_update_count();
+
+    //! Destroys all scenes, sources and items; registered callbacks are kept.
+    void reset();
+}
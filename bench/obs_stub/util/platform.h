@@ -0,0 +1,8 @@
+#pragma once
+
+// Stand-in for util/platform.h with the clock the video frame times are taken from.
+#include <cstdint>
+
+extern "C" {
+    uint64_t os_gettime_ns(void);
+}
@@ -0,0 +1,314 @@
+#include "animation_scheduler.h"
+#include "logger.h"
+#include "metrics.h"
+#include "motion_constraints.h"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <util/platform.h>
+
+namespace ObsCamMove {
+    void AnimationScheduler::start() {
+        std::lock_guard lock(mutex_);
+        if (running_) {
+            return;
+        }
+
+        obs_add_tick_callback(on_video_tick, this);
+        running_ = true;
+        log_debug("Animation scheduler attached to video tick");
+    }
+
+    void AnimationScheduler::stop() {
+        {
+            std::lock_guard lock(mutex_);
+            if (!running_) {
+                return;
+            }
+            running_ = false;
+        }
+
+        // Must not hold the mutex here: OBS waits for a running tick to finish
+        obs_remove_tick_callback(on_video_tick, this);
+
+        std::lock_guard lock(mutex_);
+        for (obs_sceneitem_t* item : animations_.items()) {
+            obs_sceneitem_release(item);
+        }
+        animations_.clear();
+        opacity_filters_.clear();
+        pending_starts_.clear();
+        last_frame_time_ns_ = 0;
+        last_frame_interval_ns_ = 0;
+        log_debug("Animation scheduler detached from video tick");
+    }
+
+    // The batch open on this thread, if any, and the storage of its animations and commit actions, kept
+    // for the next batch
+    static thread_local AnimationBatch* current_batch = nullptr;
+    static thread_local std::vector<CameraAnimation> batch_animations;
+    static thread_local std::vector<std::function<void()>> batch_commit_actions;
+
+    AnimationBatch::AnimationBatch() : animations_(batch_animations), commit_actions_(batch_commit_actions) {
+        if (current_batch != nullptr) {
+            throw std::logic_error("Animation batches can not be nested");
+        }
+        current_batch = this;
+    }
+
+    AnimationBatch::~AnimationBatch() {
+        current_batch = nullptr;
+        commit_actions_.clear();
+        release();
+    }
+
+    bool AnimationBatch::commit() {
+        if (failed() || !AnimationScheduler::get_instance().commit(*this)) {
+            return false; // The destructor releases the staged animations
+        }
+
+        for (const auto& action : commit_actions_) {
+            action();
+        }
+        commit_actions_.clear();
+        return true;
+    }
+
+    AnimationBatch* AnimationBatch::current() {
+        return current_batch;
+    }
+
+    void AnimationBatch::fail(String error) {
+        if (error_.empty()) {
+            error_ = std::move(error);
+        }
+    }
+
+    void AnimationBatch::on_commit(std::function<void()> action) {
+        commit_actions_.push_back(std::move(action));
+    }
+
+    void AnimationBatch::release() {
+        for (const auto& animation : animations_) {
+            obs_sceneitem_release(animation.item);
+        }
+        animations_.clear();
+    }
+
+    bool AnimationScheduler::schedule(CameraAnimation animation) {
+        if (current_batch != nullptr) {
+            return stage(*current_batch, std::move(animation));
+        }
+
+        // Under the mutex the tick sees either the old or the new animation, never a mix of both
+        std::lock_guard lock(mutex_);
+        return start_locked(std::move(animation));
+    }
+
+    bool AnimationScheduler::start_locked(CameraAnimation animation) {
+        obs_sceneitem_t* item = animation.item;
+        OpacityFilter opacity = std::move(animation.opacity);
+        if (animation.interrupt) {
+            if (animations_.replace(animation.item, animation.start, animation.target,
+                                    animation.duration_ns, animation.easing, std::move(animation.path))) {
+                obs_sceneitem_addref(item);
+            }
+        } else if (animations_.add(animation.item, animation.start, animation.target,
+                                   animation.duration_ns, animation.easing, std::move(animation.path))) {
+            obs_sceneitem_addref(item); // Keep the item alive until the animation is finished
+        } else {
+            return false;
+        }
+
+        // A replacing animation that does not fade keeps the filter of the one it replaced
+        if (opacity.filter) {
+            opacity_filters_[item] = std::move(opacity);
+        }
+        pending_starts_.push_back(steady_clock_ns());
+        return true;
+    }
+
+    bool AnimationScheduler::stage(AnimationBatch& batch, CameraAnimation animation) {
+        const auto staged = std::ranges::find(batch.animations_, animation.item, &CameraAnimation::item);
+        if (!animation.interrupt) {
+            std::lock_guard lock(mutex_);
+            const bool overlaps = staged != batch.animations_.end() && (staged->target.mask & animation.target.mask);
+            if (overlaps || animations_.contains(animation.item)) {
+                batch.fail(std::format("Scene item \"{}\" is already moving",
+                                       obs_source_get_name(obs_sceneitem_get_source(animation.item))));
+                return false;
+            }
+        }
+
+        // A later animation of the same item in the batch replaces the earlier one; channels only the earlier
+        // one animates are kept, so e.g. a zoom and a move of the camera run together
+        obs_sceneitem_addref(animation.item);
+        if (staged != batch.animations_.end()) {
+            obs_sceneitem_release(staged->item);
+            if (!(animation.target.mask & POSITION_CHANNELS)) {
+                animation.path = std::move(staged->path);
+            }
+            if (!animation.opacity.filter) {
+                animation.opacity = std::move(staged->opacity);
+            }
+            for (u32 mask = staged->target.mask & ~animation.target.mask; mask != 0; mask &= mask - 1) {
+                const auto channel = static_cast<TransformChannel>(std::countr_zero(mask));
+                animation.start.set(channel, staged->start.get(channel));
+                animation.target.set(channel, staged->target.get(channel));
+            }
+            *staged = std::move(animation);
+        } else {
+            batch.animations_.push_back(std::move(animation));
+        }
+        return true;
+    }
+
+    bool AnimationScheduler::commit(AnimationBatch& batch) {
+        {
+            // One lock for all, so no tick falls between the animations of the batch
+            std::lock_guard lock(mutex_);
+
+            // Another client may have started an item since it was staged; then none of the batch starts
+            for (const auto& animation : batch.animations_) {
+                if (!animation.interrupt && animations_.contains(animation.item)) {
+                    batch.fail(std::format("Scene item \"{}\" started moving before the batch was committed",
+                                           obs_source_get_name(obs_sceneitem_get_source(animation.item))));
+                    return false;
+                }
+            }
+
+            for (auto& animation : batch.animations_) {
+                (void)start_locked(std::move(animation));
+            }
+        }
+        batch.release();
+        return true;
+    }
+
+    bool AnimationScheduler::is_animating(const obs_sceneitem_t* item, const ChannelMask channels) {
+        std::lock_guard lock(mutex_);
+        return (animations_.get_channels(item) & channels) != 0;
+    }
+
+    float AnimationScheduler::get_progress(const obs_sceneitem_t* item) {
+        std::lock_guard lock(mutex_);
+        return animations_.get_progress(item);
+    }
+
+    void AnimationScheduler::on_video_tick(void* param, float) {
+        static_cast<AnimationScheduler*>(param)->tick(obs_get_video_frame_time());
+    }
+
+    void AnimationScheduler::tick(const u64 frame_time_ns) {
+        {
+            // Only the tween state is touched under the mutex; libobs is called after releasing it, so a
+            // command thread waiting for the mutex never waits for OBS as well
+            std::lock_guard lock(mutex_);
+            if (animations_.empty()) {
+                last_frame_time_ns_ = 0;
+                last_frame_interval_ns_ = 0;
+                return;
+            }
+
+            animations_.advance(frame_time_ns);
+
+            const auto items = animations_.items();
+            const auto channels = animations_.channels();
+            frame_.resize(items.size());
+            for (usize i = 0; i < items.size(); i++) {
+                auto& transform = frame_[i];
+                transform.item = items[i];
+                transform.values = {};
+                for (u32 mask = channels[i]; mask != 0; mask &= mask - 1) {
+                    const auto channel = static_cast<TransformChannel>(std::countr_zero(mask));
+                    transform.values.set(channel, animations_.value(channel)[i]);
+                }
+
+                // The filter is only handed out when the opacity changed since it was last written
+                if (transform.values.mask & channel_bit(TransformChannel::Opacity)) {
+                    const float value = std::clamp(transform.values.get(TransformChannel::Opacity), 0.0f, 1.0f);
+                    if (const auto it = opacity_filters_.find(items[i]);
+                        it != opacity_filters_.end() && it->second.applied != value) {
+                        it->second.applied = value;
+                        transform.opacity = it->second;
+                    }
+                }
+            }
+
+            record_frame_metrics(frame_time_ns);
+
+            // Finished items keep the table's reference until their last transform is applied
+            animations_.remove_finished([this](obs_sceneitem_t* item) {
+                opacity_filters_.erase(item);
+                finished_items_.push_back(item);
+            });
+        }
+
+        // All items are updated in one deferred-update window, so their transforms change together
+        for (const auto& transform : frame_) {
+            obs_sceneitem_defer_update_begin(transform.item);
+        }
+        auto& constraints = MotionConstraints::get_instance();
+        const bool constrained = constraints.is_active();
+        for (auto& [item, values, opacity] : frame_) {
+            if (constrained && (values.mask & POSITION_CHANNELS)) {
+                vec2 pos;
+                obs_sceneitem_get_pos(item, &pos);
+                const vec2 allowed = constraints.constrain(item, pos, { values.get(TransformChannel::PosX),
+                                                                        values.get(TransformChannel::PosY) });
+                values.set(TransformChannel::PosX, allowed.x);
+                values.set(TransformChannel::PosY, allowed.y);
+            }
+            apply_transform(item, values, &opacity);
+        }
+        for (auto& transform : frame_) {
+            obs_sceneitem_defer_update_end(transform.item);
+            transform.opacity = {};
+        }
+
+        for (obs_sceneitem_t* item : finished_items_) {
+            obs_sceneitem_release(item);
+        }
+        finished_items_.clear();
+    }
+
+    void AnimationScheduler::record_frame_metrics(const u64 frame_time_ns) {
+        auto& metrics = Metrics::get_instance();
+        if (!pending_starts_.empty()) {
+            const u64 now_ns = steady_clock_ns();
+            for (const u64 scheduled_ns : pending_starts_) {
+                metrics.move_start_latency.record(now_ns - scheduled_ns);
+            }
+            metrics.moves_started.fetch_add(pending_starts_.size(), std::memory_order_relaxed);
+            pending_starts_.clear();
+        }
+
+        // os_gettime_ns is the clock of the frame times; the difference is how late the positions were applied
+        const u64 now_ns = os_gettime_ns();
+        metrics.frame_lateness.record(now_ns > frame_time_ns ? now_ns - frame_time_ns : 0);
+        if (last_frame_time_ns_ != 0 && frame_time_ns > last_frame_time_ns_) {
+            const u64 interval_ns = frame_time_ns - last_frame_time_ns_;
+            metrics.frame_interval.record(interval_ns);
+            if (last_frame_interval_ns_ != 0) {
+                metrics.frame_jitter.record(interval_ns > last_frame_interval_ns_
+                    ? interval_ns - last_frame_interval_ns_
+                    : last_frame_interval_ns_ - interval_ns);
+            }
+            last_frame_interval_ns_ = interval_ns;
+        }
+        last_frame_time_ns_ = frame_time_ns;
+        metrics.frames_applied.fetch_add(1, std::memory_order_relaxed);
+
+        // Positions are computed from the frame time against each tween's deadline, so a late or dropped
+        // frame does not shift the end of a move; what remains is how far the last frame lies past it
+        const auto finished = animations_.finished();
+        u64 moves_finished = 0;
+        for (usize i = 0; i < finished.size(); i++) {
+            if (finished[i]) {
+                metrics.move_overshoot.record(frame_time_ns - animations_.get_deadline_ns(i));
+                moves_finished++;
+            }
+        }
+        metrics.moves_finished.fetch_add(moves_finished, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "prerequisites.h"
+#include "animation_table.h"
+#include "camera_easing.h"
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <obs.h>
+
+namespace ObsCamMove {
+    struct CameraAnimation {
+        obs_sceneitem_t* item = nullptr;
+        TransformValues start;  // Current values of the channels in target.mask
+        TransformValues target;
+        u64 duration_ns = 0;
+        CameraEasingType easing = CameraEasingType::Linear;
+        std::unique_ptr<const SplinePath> path; // Followed instead of the straight line if set
+        bool interrupt = false;                 // Replaces a running animation of the item
+        OpacityFilter opacity;                  // Set if the opacity is animated
+    };
+
+    //! Collects the animations scheduled on the current thread while it is alive, so that commit() starts
+    //! all of them with the same frame. Without commit() none of them starts. Batches can not be nested.
+    class AnimationBatch {
+    public:
+        AnimationBatch();
+        ~AnimationBatch();
+        AnimationBatch(AnimationBatch const&) = delete;
+        AnimationBatch& operator=(AnimationBatch const&) = delete;
+
+        //! Starts all staged animations, or none of them if the batch failed or one of their scene items
+        //! started moving since it was staged; false in that case, with the reason in error().
+        [[nodiscard]] bool commit();
+
+        //! The batch open on this thread, nullptr if there is none.
+        [[nodiscard]] static AnimationBatch* current();
+        //! Marks the batch as failed, so that commit() starts nothing; the first reason is kept.
+        void fail(String error);
+        [[nodiscard]] bool failed() const { return !error_.empty(); }
+        [[nodiscard]] const String& error() const { return error_; }
+        //! Runs the action after a successful commit instead of now, for side effects of staged commands.
+        void on_commit(std::function<void()> action);
+
+    private:
+        friend class AnimationScheduler;
+
+        std::vector<CameraAnimation>& animations_; // Each holds a reference on its scene item
+        std::vector<std::function<void()>>& commit_actions_;
+        String error_;
+
+        void release();
+    };
+
+    //! Evaluates all active camera animations once per rendered frame from the OBS video tick.
+    class AnimationScheduler {
+    public:
+        static AnimationScheduler& get_instance() {
+            static AnimationScheduler instance;
+            return instance;
+        }
+
+        void start();
+        void stop();
+
+        //! Queues an animation; it starts with the next rendered frame, or with the commit of the batch open
+        //! on this thread. Returns false if the scene item is already animating, unless the animation
+        //! interrupts the running one.
+        bool schedule(CameraAnimation animation);
+        //! True if an animation of the scene item animates any of the channels.
+        [[nodiscard]] bool is_animating(const obs_sceneitem_t* item, ChannelMask channels = ALL_CHANNELS);
+        //! Progress (0 to 1) of the animation of the scene item as of the last frame, -1 if it has none.
+        [[nodiscard]] float get_progress(const obs_sceneitem_t* item);
+
+    private:
+        std::mutex mutex_;
+        AnimationTable animations_;
+        // Opacity filters of the animations that fade their item, looked up once when they start
+        std::unordered_map<const obs_sceneitem_t*, OpacityFilter> opacity_filters_;
+        bool running_ = false;
+
+        //! Values of one item for the current frame, copied out under the mutex and applied after it.
+        struct FrameTransform {
+            obs_sceneitem_t* item = nullptr;
+            TransformValues values;
+            OpacityFilter opacity; // Only set if the opacity has to be written this frame
+        };
+
+        // Only used by the video tick; they keep their capacity, so a warm tick does not allocate
+        std::vector<FrameTransform> frame_;
+        std::vector<obs_sceneitem_t*> finished_items_;
+        std::vector<u64> pending_starts_; // Steady clock time each animation starting next frame was scheduled
+        u64 last_frame_time_ns_ = 0;      // Frame time of the previous tick with animations, 0 if idle
+        u64 last_frame_interval_ns_ = 0;  // Interval before the previous tick, 0 if unknown
+
+        friend class AnimationBatch;
+
+        AnimationScheduler() = default;
+        AnimationScheduler(AnimationScheduler const&) = delete;
+        AnimationScheduler& operator=(AnimationScheduler const&) = delete;
+
+        bool start_locked(CameraAnimation animation);
+        bool stage(AnimationBatch& batch, CameraAnimation animation);
+        bool commit(AnimationBatch& batch);
+
+        static void on_video_tick(void* param, float seconds);
+        void tick(u64 frame_time_ns);
+        void record_frame_metrics(u64 frame_time_ns);
+    };
+}
@@ -0,0 +1,330 @@
+#include "animation_table.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace ObsCamMove {
+    bool AnimationTable::add(obs_sceneitem_t* item, const TransformValues& start, const TransformValues& target,
+                             const u64 duration_ns, const CameraEasingType easing,
+                             std::unique_ptr<const SplinePath> path) {
+        if (!index_.try_emplace(item, items_.size()).second) {
+            return false;
+        }
+
+        const ChannelMask mask = target.mask;
+        items_.push_back(item);
+        channels_.push_back(mask);
+        for (usize c = 0; c < TRANSFORM_CHANNEL_COUNT; c++) {
+            const auto channel = static_cast<TransformChannel>(c);
+            const bool animated = mask & channel_bit(channel);
+            const float from = animated ? start.get(channel) : 0.0f;
+            start_[c].push_back(from);
+            target_[c].push_back(animated ? target.get(channel) : 0.0f);
+            value_[c].push_back(from);
+        }
+        start_time_ns_.push_back(0);
+        duration_ns_.push_back(duration_ns);
+        easing_.push_back(easing);
+        finished_.push_back(0);
+        carry_x_.push_back(0.0f);
+        carry_y_.push_back(0.0f);
+        path_count_ += path != nullptr;
+        paths_.push_back(std::move(path));
+        path_from_.push_back(0.0f);
+        return true;
+    }
+
+    bool AnimationTable::add(obs_sceneitem_t* item, const vec2 start_pos, const vec2 target_pos,
+                             const u64 duration_ns, const CameraEasingType easing,
+                             std::unique_ptr<const SplinePath> path) {
+        return add(item, TransformValues::from_position(start_pos), TransformValues::from_position(target_pos), duration_ns, easing,
+                   std::move(path));
+    }
+
+    bool AnimationTable::replace(obs_sceneitem_t* item, const TransformValues& start, const TransformValues& target,
+                                 const u64 duration_ns, const CameraEasingType easing,
+                                 std::unique_ptr<const SplinePath> path) {
+        const auto it = index_.find(item);
+        if (it == index_.end()) {
+            return add(item, start, target, duration_ns, easing, std::move(path));
+        }
+
+        const usize i = it->second;
+        // Velocity at the last shown frame. An entry that has not started yet passes on the velocity it took
+        // over itself, which is zero for one that starts from rest.
+        vec2 velocity = { 0.0f, 0.0f };
+        u64 start_time_ns = 0;
+        if (start_time_ns_[i] != 0) {
+            if (channels_[i] & POSITION_CHANNELS) {
+                velocity = velocity_at(i, progress_at(i, last_frame_time_ns_));
+            }
+            start_time_ns = last_frame_time_ns_;
+        } else if (carry_x_[i] != 0.0f || carry_y_[i] != 0.0f) {
+            velocity = velocity_at(i, 0.0f);
+        }
+        const float path_at = start_time_ns_[i] != 0 && paths_[i]
+            ? path_parameter(i, CameraEasing::calculate(easing_[i], progress_at(i, last_frame_time_ns_)))
+            : path_from_[i];
+
+        // Channels of the running tween that the new one leaves out continue from where they are
+        for (usize c = 0; c < TRANSFORM_CHANNEL_COUNT; c++) {
+            const auto channel = static_cast<TransformChannel>(c);
+            if (target.mask & channel_bit(channel)) {
+                start_[c][i] = start.get(channel);
+                target_[c][i] = target.get(channel);
+            } else if (channels_[i] & channel_bit(channel)) {
+                start_[c][i] = value_[c][i];
+            }
+        }
+        channels_[i] |= target.mask;
+        start_time_ns_[i] = start_time_ns;
+        duration_ns_[i] = duration_ns;
+        easing_[i] = easing;
+        finished_[i] = 0;
+        carry_x_[i] = 0.0f;
+        carry_y_[i] = 0.0f;
+        if (path || (target.mask & POSITION_CHANNELS)) {
+            path_count_ += (path != nullptr) - (paths_[i] != nullptr);
+            paths_[i] = std::move(path);
+            path_from_[i] = 0.0f;
+        } else {
+            path_from_[i] = path_at; // A tween without position channels lets a running path finish from here
+        }
+
+        // The new curve starts with the slope of its easing, which is not zero for Linear and the ease-out
+        // curves; the carry makes up the difference, so the speed runs on without a jump
+        if (velocity.x != 0.0f || velocity.y != 0.0f) {
+            const vec2 slope = velocity_at(i, 0.0f);
+            carry_x_[i] = velocity.x - slope.x;
+            carry_y_[i] = velocity.y - slope.y;
+        }
+        return false;
+    }
+
+    bool AnimationTable::replace(obs_sceneitem_t* item, const vec2 start_pos, const vec2 target_pos,
+                                 const u64 duration_ns, const CameraEasingType easing,
+                                 std::unique_ptr<const SplinePath> path) {
+        return replace(item, TransformValues::from_position(start_pos), TransformValues::from_position(target_pos), duration_ns, easing,
+                       std::move(path));
+    }
+
+    float AnimationTable::progress_at(const usize index, const u64 frame_time_ns) const {
+        const u64 elapsed_ns = frame_time_ns > start_time_ns_[index] ? frame_time_ns - start_time_ns_[index] : 0;
+        return elapsed_ns >= duration_ns_[index]
+            ? 1.0f
+            : static_cast<float>(elapsed_ns) / static_cast<float>(duration_ns_[index]);
+    }
+
+    vec2 AnimationTable::position_at(const usize index, const float progress) const {
+        constexpr auto X = static_cast<usize>(TransformChannel::PosX);
+        constexpr auto Y = static_cast<usize>(TransformChannel::PosY);
+        const float s = progress;
+        const float t = CameraEasing::calculate(easing_[index], s);
+
+        vec2 pos = paths_[index]
+            ? paths_[index]->point_at(path_parameter(index, t))
+            : vec2{ start_[X][index] + t * (target_[X][index] - start_[X][index]),
+                    start_[Y][index] + t * (target_[Y][index] - start_[Y][index]) };
+
+        const float carry_scale = static_cast<float>(duration_ns_[index]) * 1e-9f * (s - 2 * s * s + s * s * s);
+        pos.x += carry_x_[index] * carry_scale;
+        pos.y += carry_y_[index] * carry_scale;
+        return pos;
+    }
+
+    vec2 AnimationTable::velocity_at(const usize index, const float progress) const {
+        if (duration_ns_[index] == 0) {
+            return { 0.0f, 0.0f };
+        }
+
+        // Difference over one millisecond: backward where possible, so it only looks at shown positions
+        constexpr u64 step_ns = 1'000'000;
+        const float step = std::min(1.0f, static_cast<float>(step_ns) / static_cast<float>(duration_ns_[index]));
+        const float from = progress >= step ? progress - step : progress;
+        const vec2 a = position_at(index, from);
+        const vec2 b = position_at(index, from + step);
+        const float seconds = step * static_cast<float>(duration_ns_[index]) * 1e-9f;
+        return { (b.x - a.x) / seconds, (b.y - a.y) / seconds };
+    }
+
+    bool AnimationTable::contains(const obs_sceneitem_t* item) const {
+        return index_.contains(item);
+    }
+
+    ChannelMask AnimationTable::get_channels(const obs_sceneitem_t* item) const {
+        const auto it = index_.find(item);
+        return it != index_.end() ? channels_[it->second] : 0;
+    }
+
+    float AnimationTable::get_progress(const obs_sceneitem_t* item) const {
+        const auto it = index_.find(item);
+        if (it == index_.end()) {
+            return -1.0f;
+        }
+
+        const usize i = it->second;
+        if (start_time_ns_[i] == 0 || last_frame_time_ns_ < start_time_ns_[i]) {
+            return 0.0f; // Starts with the next frame
+        }
+        const u64 elapsed_ns = last_frame_time_ns_ - start_time_ns_[i];
+        return elapsed_ns >= duration_ns_[i] ? 1.0f : static_cast<float>(elapsed_ns) / static_cast<float>(duration_ns_[i]);
+    }
+
+    void AnimationTable::advance(const u64 frame_time_ns) {
+        last_frame_time_ns_ = frame_time_ns;
+        const usize count = items_.size();
+        progress_.resize(count);
+        eased_.resize(count);
+
+        u32 easing_mask = 0;
+        ChannelMask channel_mask = 0;
+        for (usize i = 0; i < count; i++) {
+            if (start_time_ns_[i] == 0) {
+                start_time_ns_[i] = frame_time_ns;
+            }
+
+            const u64 elapsed_ns = frame_time_ns - start_time_ns_[i];
+            const bool done = elapsed_ns >= duration_ns_[i];
+            progress_[i] = done ? 1.0f : static_cast<float>(elapsed_ns) / static_cast<float>(duration_ns_[i]);
+            finished_[i] = done;
+            easing_mask |= 1u << static_cast<u32>(easing_[i]);
+            channel_mask |= channels_[i];
+        }
+
+        // Evaluate each easing curve once over all tweens that use it
+        if (std::has_single_bit(easing_mask)) {
+            CameraEasing::calculate(easing_[0], progress_, eased_);
+        } else {
+            for (u32 mask = easing_mask; mask != 0; mask &= mask - 1) {
+                const auto easing = static_cast<CameraEasingType>(std::countr_zero(mask));
+
+                batch_index_.clear();
+                batch_in_.clear();
+                for (usize i = 0; i < count; i++) {
+                    if (easing_[i] == easing) {
+                        batch_index_.push_back(i);
+                        batch_in_.push_back(progress_[i]);
+                    }
+                }
+
+                batch_out_.resize(batch_in_.size());
+                CameraEasing::calculate(easing, batch_in_, batch_out_);
+                for (usize k = 0; k < batch_index_.size(); k++) {
+                    eased_[batch_index_[k]] = batch_out_[k];
+                }
+            }
+        }
+
+        // One pass per channel column that any tween animates, sharing the eased progress
+        for (u32 mask = channel_mask; mask != 0; mask &= mask - 1) {
+            const usize c = std::countr_zero(mask);
+            const float* start = start_[c].data();
+            const float* target = target_[c].data();
+            float* value = value_[c].data();
+            for (usize i = 0; i < count; i++) {
+                value[i] = start[i] + eased_[i] * (target[i] - start[i]);
+            }
+        }
+
+        if (!(channel_mask & POSITION_CHANNELS)) {
+            snap_finished(channel_mask);
+            return;
+        }
+
+        auto& pos_x = value_[static_cast<usize>(TransformChannel::PosX)];
+        auto& pos_y = value_[static_cast<usize>(TransformChannel::PosY)];
+        if (path_count_ > 0) {
+            for (usize i = 0; i < count; i++) {
+                if (paths_[i]) {
+                    const vec2 pos = paths_[i]->point_at(path_parameter(i, eased_[i]));
+                    pos_x[i] = pos.x;
+                    pos_y[i] = pos.y;
+                }
+            }
+        }
+
+        // The carry fades out along the Hermite basis s - 2s² + s³, which starts with slope 1 and ends at 0
+        // with slope 0, so it sets the initial velocity without moving the target
+        for (usize i = 0; i < count; i++) {
+            const float s = progress_[i];
+            const float carry_scale = static_cast<float>(duration_ns_[i]) * 1e-9f * (s - 2 * s * s + s * s * s);
+            pos_x[i] += carry_x_[i] * carry_scale;
+            pos_y[i] += carry_y_[i] * carry_scale;
+        }
+
+        snap_finished(channel_mask);
+    }
+
+    void AnimationTable::snap_finished(const ChannelMask channel_mask) {
+        // Land exactly on the target instead of start + 1.0 * (target - start)
+        for (u32 mask = channel_mask; mask != 0; mask &= mask - 1) {
+            const usize c = std::countr_zero(mask);
+            for (usize i = 0; i < items_.size(); i++) {
+                if (finished_[i]) {
+                    value_[c][i] = target_[c][i];
+                }
+            }
+        }
+    }
+
+    void AnimationTable::clear() {
+        items_.clear();
+        channels_.clear();
+        for (usize c = 0; c < TRANSFORM_CHANNEL_COUNT; c++) {
+            start_[c].clear();
+            target_[c].clear();
+            value_[c].clear();
+        }
+        start_time_ns_.clear();
+        duration_ns_.clear();
+        easing_.clear();
+        finished_.clear();
+        carry_x_.clear();
+        carry_y_.clear();
+        paths_.clear();
+        path_from_.clear();
+        path_count_ = 0;
+        index_.clear();
+    }
+
+    void AnimationTable::remove_at(const usize index) {
+        // Swap-remove keeps the arrays dense; only the moved entry needs a new index
+        const usize last = items_.size() - 1;
+        index_.erase(items_[index]);
+        path_count_ -= paths_[index] != nullptr;
+        if (index != last) {
+            items_[index] = items_[last];
+            channels_[index] = channels_[last];
+            for (usize c = 0; c < TRANSFORM_CHANNEL_COUNT; c++) {
+                start_[c][index] = start_[c][last];
+                target_[c][index] = target_[c][last];
+                value_[c][index] = value_[c][last];
+            }
+            start_time_ns_[index] = start_time_ns_[last];
+            duration_ns_[index] = duration_ns_[last];
+            easing_[index] = easing_[last];
+            finished_[index] = finished_[last];
+            carry_x_[index] = carry_x_[last];
+            carry_y_[index] = carry_y_[last];
+            paths_[index] = std::move(paths_[last]);
+            path_from_[index] = path_from_[last];
+            index_[items_[index]] = index;
+        }
+
+        items_.pop_back();
+        channels_.pop_back();
+        for (usize c = 0; c < TRANSFORM_CHANNEL_COUNT; c++) {
+            start_[c].pop_back();
+            target_[c].pop_back();
+            value_[c].pop_back();
+        }
+        start_time_ns_.pop_back();
+        duration_ns_.pop_back();
+        easing_.pop_back();
+        finished_.pop_back();
+        carry_x_.pop_back();
+        carry_y_.pop_back();
+        paths_.pop_back();
+        path_from_.pop_back();
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "prerequisites.h"
+#include "camera_easing.h"
+#include "spline_path.h"
+#include "transform_channels.h"
+#include <array>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include <obs.h>
+
+namespace ObsCamMove {
+    //! Transform tweens of many scene items, stored as structure-of-arrays with one column per channel,
+    //! so that a single pass per frame can advance all of them.
+    class AnimationTable {
+    public:
+        //! Adds a tween of the channels in target.mask, which start must contain as well; returns false if
+        //! the item is already animating. With a path, the item follows it from the start to the target
+        //! position (its end points) instead of a straight line.
+        bool add(obs_sceneitem_t* item, const TransformValues& start, const TransformValues& target,
+                 u64 duration_ns, CameraEasingType easing, std::unique_ptr<const SplinePath> path = nullptr);
+        bool add(obs_sceneitem_t* item, vec2 start_pos, vec2 target_pos, u64 duration_ns, CameraEasingType easing,
+                 std::unique_ptr<const SplinePath> path = nullptr);
+        //! Adds a tween, or replaces the running tween of the item. The new tween starts at the last
+        //! evaluated frame and takes over the velocity the item had there, so the item neither jumps
+        //! nor stalls. Channels only the running tween animates keep their target and take the new timing.
+        //! Returns true if the tween was added rather than replaced.
+        bool replace(obs_sceneitem_t* item, const TransformValues& start, const TransformValues& target,
+                     u64 duration_ns, CameraEasingType easing, std::unique_ptr<const SplinePath> path = nullptr);
+        bool replace(obs_sceneitem_t* item, vec2 start_pos, vec2 target_pos, u64 duration_ns, CameraEasingType easing,
+                     std::unique_ptr<const SplinePath> path = nullptr);
+        [[nodiscard]] bool contains(const obs_sceneitem_t* item) const;
+        //! Channels the tween of the item animates, 0 if it has none.
+        [[nodiscard]] ChannelMask get_channels(const obs_sceneitem_t* item) const;
+        //! Linear progress (0 to 1) of the tween of the item as of the last advance(), -1 if it has none.
+        [[nodiscard]] float get_progress(const obs_sceneitem_t* item) const;
+        [[nodiscard]] usize size() const { return items_.size(); }
+        [[nodiscard]] bool empty() const { return items_.empty(); }
+
+        //! Evaluates all tweens for the given frame timestamp. Tweens that have not
+        //! been evaluated before start at this frame.
+        void advance(u64 frame_time_ns);
+
+        //! Results of the last advance(), index-aligned with items().
+        [[nodiscard]] std::span<obs_sceneitem_t* const> items() const { return items_; }
+        [[nodiscard]] std::span<const ChannelMask> channels() const { return channels_; }
+        [[nodiscard]] std::span<const float> value(const TransformChannel channel) const {
+            return value_[static_cast<usize>(channel)];
+        }
+        [[nodiscard]] std::span<const float> pos_x() const { return value(TransformChannel::PosX); }
+        [[nodiscard]] std::span<const float> pos_y() const { return value(TransformChannel::PosY); }
+
+        //! Time each tween is due to end: the frame it started with plus its duration. Tweens end with the
+        //! first frame at or after it, so no tween runs more than one frame longer than requested.
+        [[nodiscard]] u64 get_deadline_ns(const usize index) const { return start_time_ns_[index] + duration_ns_[index]; }
+        [[nodiscard]] std::span<const u8> finished() const { return finished_; }
+
+        //! Removes every tween that reached its target, passing its item to the callback.
+        template<typename Callback>
+        void remove_finished(Callback&& on_removed) {
+            for (usize i = 0; i < items_.size();) {
+                if (finished_[i]) {
+                    obs_sceneitem_t* item = items_[i];
+                    remove_at(i);
+                    on_removed(item);
+                } else {
+                    ++i;
+                }
+            }
+        }
+
+        void clear();
+
+    private:
+        using Column = std::vector<float>;
+
+        std::vector<obs_sceneitem_t*> items_;
+        std::vector<ChannelMask> channels_;
+        // Channels an entry does not animate hold start == target, so the pass over a column needs no mask
+        std::array<Column, TRANSFORM_CHANNEL_COUNT> start_;
+        std::array<Column, TRANSFORM_CHANNEL_COUNT> target_;
+        std::array<Column, TRANSFORM_CHANNEL_COUNT> value_;
+        std::vector<u64> start_time_ns_;
+        std::vector<u64> duration_ns_;
+        std::vector<CameraEasingType> easing_;
+        std::vector<u8> finished_;
+        // Velocity taken over from a replaced tween minus the initial slope of the new curve, in pixels per second
+        std::vector<float> carry_x_;
+        std::vector<float> carry_y_;
+        std::vector<std::unique_ptr<const SplinePath>> paths_; // Null for straight tweens
+        std::vector<float> path_from_; // Arc-length fraction a path resumes from after a replace kept it
+        usize path_count_ = 0;
+        u64 last_frame_time_ns_ = 0;
+        std::unordered_map<const obs_sceneitem_t*, usize> index_;
+
+        // Per-frame scratch buffers; they only grow, so advance() does not allocate on a warm path
+        std::vector<float> progress_;
+        std::vector<float> eased_;
+        std::vector<usize> batch_index_;
+        std::vector<float> batch_in_;
+        std::vector<float> batch_out_;
+
+        void remove_at(usize index);
+        void snap_finished(ChannelMask channel_mask);
+        [[nodiscard]] float progress_at(usize index, u64 frame_time_ns) const;
+        //! Maps eased progress onto the part of the path that is left.
+        [[nodiscard]] float path_parameter(const usize index, const float eased) const {
+            return path_from_[index] + eased * (1.0f - path_from_[index]);
+        }
+        //! Position of a tween at the given progress, evaluated on its own (not for the per-frame pass).
+        [[nodiscard]] vec2 position_at(usize index, float progress) const;
+        //! Velocity of a tween at the given progress in pixels per second.
+        [[nodiscard]] vec2 velocity_at(usize index, float progress) const;
+    };
+}
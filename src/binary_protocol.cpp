@@ -0,0 +1,90 @@
+#include "binary_protocol.h"
+#include <bit>
+#include <cstring>
+
+namespace ObsCamMove {
+    static u32 read_u32_le(const char* data) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+        return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<u32>(bytes[3]) << 24);
+    }
+
+    static void append_u32_le(String& out, const u32 value) {
+        const char bytes[] = {
+            static_cast<char>(value & 0xFF), static_cast<char>((value >> 8) & 0xFF),
+            static_cast<char>((value >> 16) & 0xFF), static_cast<char>((value >> 24) & 0xFF)
+        };
+        out.append(bytes, sizeof(bytes));
+    }
+
+    static void append_f32_le(String& out, const float value) {
+        append_u32_le(out, std::bit_cast<u32>(value));
+    }
+
+    static void append_reply_header(String& out, const u8 opcode, const BinaryStatus status, const usize length) {
+        out.push_back(static_cast<char>(opcode));
+        out.push_back(static_cast<char>(status));
+        out.append(2, '\0');
+        append_u32_le(out, static_cast<u32>(length));
+    }
+
+    std::optional<BinaryFrame> decode_binary_frame(const StringView frame) {
+        if (frame.size() != BinaryFrame::SIZE) {
+            return std::nullopt;
+        }
+
+        BinaryFrame result{};
+        result.opcode = static_cast<BinaryOpcode>(static_cast<u8>(frame[0]));
+        result.easing = static_cast<u8>(frame[1]);
+
+        const u32 raw_x = read_u32_le(frame.data() + 4);
+        const u32 raw_y = read_u32_le(frame.data() + 8);
+        if (static_cast<u8>(frame[2]) & BinaryFrame::FLAG_FLOAT_COORDINATES) {
+            result.x = std::bit_cast<float>(raw_x);
+            result.y = std::bit_cast<float>(raw_y);
+        } else {
+            result.x = static_cast<float>(static_cast<i32>(raw_x));
+            result.y = static_cast<float>(static_cast<i32>(raw_y));
+        }
+        result.duration_ms = static_cast<i32>(read_u32_le(frame.data() + 12));
+        return result;
+    }
+
+    StringView get_binary_command_name(const BinaryOpcode opcode) {
+        switch (opcode) {
+            case BinaryOpcode::MoveTo: return "move_to";
+            case BinaryOpcode::MoveBy: return "move_by";
+            case BinaryOpcode::GetCameraPosition: return "get_camera_position";
+            case BinaryOpcode::GetCameraName: return "get_camera_name";
+            case BinaryOpcode::SetVelocity: return "set_velocity";
+            case BinaryOpcode::SetTarget: return "set_target";
+            case BinaryOpcode::SubscribePosition: return "subscribe_position";
+            case BinaryOpcode::GetCameraScale: return "get_scale";
+            case BinaryOpcode::GetCameraState: return "get_camera_state";
+            default: return {};
+        }
+    }
+
+    void append_binary_reply(String& out, const u8 opcode, const BinaryStatus status, const StringView payload) {
+        append_reply_header(out, opcode, status, payload.size());
+        out.append(payload);
+    }
+
+    void append_binary_reply(String& out, const u8 opcode, const vec2 value) {
+        append_reply_header(out, opcode, BinaryStatus::Ok, BINARY_VEC2_PAYLOAD_SIZE);
+        append_f32_le(out, value.x);
+        append_f32_le(out, value.y);
+    }
+
+    void append_binary_state_reply(String& out, const vec2 position, const vec2 scale, const float progress,
+                                   const bool moving) {
+        append_reply_header(out, static_cast<u8>(BinaryOpcode::GetCameraState), BinaryStatus::Ok,
+                            BINARY_STATE_PAYLOAD_SIZE);
+        append_f32_le(out, position.x);
+        append_f32_le(out, position.y);
+        append_f32_le(out, scale.x);
+        append_f32_le(out, scale.y);
+        append_f32_le(out, progress);
+        out.push_back(static_cast<char>(moving));
+        out.append(3, '\0');
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "prerequisites.h"
+#include <optional>
+#include <obs.h>
+
+namespace ObsCamMove {
+    //! First byte of a connection that speaks the binary protocol (never valid for text commands).
+    constexpr u8 BINARY_PROTOCOL_MAGIC = 0xCB;
+
+    enum class BinaryOpcode : u8 {
+        MoveTo            = 0x01,
+        MoveBy            = 0x02,
+        GetCameraPosition = 0x03,
+        GetCameraName     = 0x04,
+        SetVelocity       = 0x05, // x, y: velocity in pixels per second
+        SetTarget         = 0x06,
+        SubscribePosition = 0x07, // x: updates per second, 0 unsubscribes; updates are sent as replies of this opcode
+        GetCameraScale    = 0x08,
+        GetCameraState    = 0x09,
+    };
+
+    enum class BinaryStatus : u8 {
+        Ok    = 0,
+        Error = 1,
+    };
+
+    //! Request frame, 16 bytes, little-endian:
+    //!   u8 opcode | u8 easing | u8 flags | u8 reserved | x (i32/f32) | y (i32/f32) | i32 duration_ms
+    //! Bit 0 of flags marks x/y as float32 instead of int32.
+    struct BinaryFrame {
+        static constexpr usize SIZE = 16;
+        static constexpr u8 FLAG_FLOAT_COORDINATES = 0x01;
+
+        BinaryOpcode opcode;
+        u8 easing;
+        float x;
+        float y;
+        i32 duration_ms;
+    };
+
+    //! Reply frame, 8 byte header followed by payload_length bytes:
+    //!   u8 opcode | u8 status | u16 reserved | u32 payload_length
+    //! A successful command without a value ("OK") has an empty payload. Queries answer with fixed
+    //! little-endian fields, errors and the camera name with UTF-8 text:
+    //!   GetCameraPosition, GetCameraScale, position updates: f32 x | f32 y
+    //!   GetCameraState: f32 x | f32 y | f32 scale_x | f32 scale_y | f32 progress | u8 moving | u8[3] reserved
+    constexpr usize BINARY_REPLY_HEADER_SIZE = 8;
+    constexpr usize BINARY_VEC2_PAYLOAD_SIZE = 8;
+    constexpr usize BINARY_STATE_PAYLOAD_SIZE = 24;
+
+    [[nodiscard]] std::optional<BinaryFrame> decode_binary_frame(StringView frame);
+    [[nodiscard]] StringView get_binary_command_name(BinaryOpcode opcode);
+    void append_binary_reply(String& out, u8 opcode, BinaryStatus status, StringView payload);
+    //! Appends a successful reply whose payload is the two floats of value.
+    void append_binary_reply(String& out, u8 opcode, vec2 value);
+    //! Appends a successful GetCameraState reply.
+    void append_binary_state_reply(String& out, vec2 position, vec2 scale, float progress, bool moving);
+}
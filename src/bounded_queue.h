@@ -0,0 +1,75 @@
+#pragma once
+
+#include "prerequisites.h"
+#include <atomic>
+#include <bit>
+#include <memory>
+
+namespace ObsCamMove {
+    //! Lock-free bounded multi-producer/multi-consumer queue (Dmitry Vyukov's algorithm).
+    //! try_push fails instead of blocking when the queue is full.
+    template<typename T>
+    class BoundedQueue {
+    public:
+        explicit BoundedQueue(const usize capacity)
+            : cells_(std::make_unique<Cell[]>(std::bit_ceil(capacity))), mask_(std::bit_ceil(capacity) - 1) {
+            for (usize i = 0; i <= mask_; i++) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        bool try_push(T&& value) {
+            usize pos = enqueue_pos_.load(std::memory_order_relaxed);
+            while (true) {
+                Cell& cell = cells_[pos & mask_];
+                const usize sequence = cell.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        cell.value = std::move(value);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false; // Full
+                } else {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool try_pop(T& value) {
+            usize pos = dequeue_pos_.load(std::memory_order_relaxed);
+            while (true) {
+                Cell& cell = cells_[pos & mask_];
+                const usize sequence = cell.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+                if (diff == 0) {
+                    if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        value = std::move(cell.value);
+                        cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false; // Empty
+                } else {
+                    pos = dequeue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+    private:
+        struct Cell {
+            std::atomic<usize> sequence;
+            T value;
+        };
+
+        std::unique_ptr<Cell[]> cells_;
+        const usize mask_;
+        alignas(64) std::atomic<usize> enqueue_pos_ = 0;
+        alignas(64) std::atomic<usize> dequeue_pos_ = 0;
+    };
+}
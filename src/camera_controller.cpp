@@ -1,12 +1,63 @@
 #include "camera_controller.h"
+#include "animation_scheduler.h"
 #include "camera_easing.h"
 #include "logger.h"
+#include "motion_constraints.h"
 #include "string_utils.h"
 #include <obs.h>
 #include <obs-frontend-api.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
 
 namespace ObsCamMove {
-    CameraController::CameraController() : camera_moving_(false) {
+    static u64 pack_vec2(const vec2 value) {
+        return static_cast<u64>(std::bit_cast<u32>(value.x)) | static_cast<u64>(std::bit_cast<u32>(value.y)) << 32;
+    }
+
+    static vec2 unpack_vec2(const u64 value) {
+        return { std::bit_cast<float>(static_cast<u32>(value)), std::bit_cast<float>(static_cast<u32>(value >> 32)) };
+    }
+
+    //! Copies the name into the fixed-size buffer; false if it had to be truncated.
+    static bool copy_name(std::array<char, CameraNames::NAME_SIZE>& target, const char* name) {
+        const usize length = name ? std::strlen(name) : 0;
+        const usize copied = std::min(length, target.size() - 1);
+        std::memcpy(target.data(), name ? name : "", copied);
+        target[copied] = '\0';
+        return copied == length;
+    }
+
+    static i64 steady_now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    CameraController::CameraController() = default;
+
+    void CameraController::start() {
+        obs_frontend_add_event_callback(on_frontend_event, this);
+        signal_handler_connect(obs_get_signal_handler(), "source_rename", on_scene_signal, this);
+        obs_add_tick_callback(on_video_tick, this);
+    }
+
+    void CameraController::stop() {
+        obs_remove_tick_callback(on_video_tick, this);
+        control_mode_.store(ControlMode::None);
+        control_velocity_ = {};
+        control_moving_.store(false);
+        {
+            std::lock_guard lock(follow_mutex_);
+            follow_ = {};
+        }
+        obs_frontend_remove_event_callback(on_frontend_event, this);
+        signal_handler_disconnect(obs_get_signal_handler(), "source_rename", on_scene_signal, this);
+        invalidate_cache();
+        // The tick is removed, so this is the only writer
+        state_.store({});
+        names_.store({});
+        names_generation_ = UINT64_MAX;
     }
 
     String CameraController::log_error(const String& error_message) {
@@ -14,73 +65,146 @@ namespace ObsCamMove {
         return "ERROR: " + error_message;
     }
 
-    String CameraController::get_camera_value(const GetCameraValueCallback &get_value_function) const {
-        if (camera_names_.empty()) {
-            return log_error("Unable to find any camera items!");
+    void CameraController::on_frontend_event(const obs_frontend_event event, void* param) {
+        switch (event) {
+            case OBS_FRONTEND_EVENT_SCENE_CHANGED:
+            case OBS_FRONTEND_EVENT_SCENE_LIST_CHANGED:
+            case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED:
+            case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CLEANUP:
+            case OBS_FRONTEND_EVENT_EXIT:
+                static_cast<CameraController*>(param)->invalidate_cache();
+                break;
+            default:
+                break;
         }
+    }
 
-        const auto scene_source = obs_frontend_get_current_scene();
-        if (!scene_source) {
-            return log_error("No current scene available!");
+    void CameraController::on_scene_signal(void* param, calldata_t*) {
+        static_cast<CameraController*>(param)->invalidate_cache();
+    }
+
+    void CameraController::invalidate_cache() const {
+        // Only lock-free reference counting happens under cache_mutex_: signals may be emitted while
+        // libobs holds scene locks, so calling into the scene API here could deadlock
+        CameraCache previous;
+        {
+            std::lock_guard lock(cache_mutex_);
+            cache_generation_++;
+            std::swap(previous, cache_);
+        }
+        disconnect_scene_signals(previous.scene_source.get());
+    }
+
+    void CameraController::disconnect_scene_signals(obs_source_t* scene_source) const {
+        if (scene_source == nullptr) {
+            return;
         }
 
-        const auto scene = obs_scene_from_source(scene_source);
-        obs_source_release(scene_source); // Important: Releasing the source to prevent memory leaks!
+        const auto handler = obs_source_get_signal_handler(scene_source);
+        signal_handler_disconnect(handler, "item_add", on_scene_signal, const_cast<CameraController*>(this));
+        signal_handler_disconnect(handler, "item_remove", on_scene_signal, const_cast<CameraController*>(this));
+    }
+
+    CameraController::CameraCache CameraController::resolve_camera_cache(const std::vector<String>& camera_names) const {
+        CameraCache resolved;
+        resolved.valid = true;
+
+        if (camera_names.empty()) {
+            resolved.error = "Unable to find any camera items!";
+            return resolved;
+        }
+
+        resolved.scene_source = SourceRef::adopt(obs_frontend_get_current_scene());
+        if (!resolved.scene_source) {
+            resolved.error = "No current scene available!";
+            return resolved;
+        }
+
+        const auto scene = obs_scene_from_source(resolved.scene_source.get());
         if (!scene) {
-            return log_error("Current source is not a scene!");
+            resolved.error = "Current source is not a scene!";
+            return resolved;
         }
 
-        obs_sceneitem_t* camera = nullptr;
-        for (const auto& source_name : camera_names_) {
+        for (const auto& source_name : camera_names) {
             if (obs_sceneitem_t* item = obs_scene_find_source(scene, source_name.c_str())) {
-                camera = item;
-                break;
+                resolved.camera_item = SceneItemRef(item);
+                return resolved;
             }
         }
 
-        if (!camera) {
-            return log_error("No camera in current scene found!");
+        // Cached as well: an item_add signal invalidates it once a camera is added
+        resolved.error = "No camera in current scene found!";
+        return resolved;
+    }
+
+    SceneItemRef CameraController::find_active_camera_item(String* error) const {
+        std::vector<String> camera_names;
+        u64 generation;
+        {
+            std::lock_guard lock(cache_mutex_);
+            if (cache_.valid) {
+                if (error) *error = cache_.error;
+                return cache_.camera_item;
+            }
+            camera_names.assign(camera_names_.begin(), camera_names_.end());
+            generation = cache_generation_;
         }
 
-        const auto camera_source = obs_sceneitem_get_source(camera);
-        if (camera_source == nullptr) {
-            return log_error("ERROR: Source item for camera not found");
+        // Cold path: search the scene and subscribe to changes of its items
+        CameraCache resolved = resolve_camera_cache(camera_names);
+        if (error) *error = resolved.error;
+        SceneItemRef camera_item = resolved.camera_item;
+
+        const auto scene_source = resolved.scene_source.get();
+        if (scene_source) {
+            const auto handler = obs_source_get_signal_handler(scene_source);
+            signal_handler_connect(handler, "item_add", on_scene_signal, const_cast<CameraController*>(this));
+            signal_handler_connect(handler, "item_remove", on_scene_signal, const_cast<CameraController*>(this));
         }
 
-        return get_value_function(scene, camera, camera_source);
-    }
+        bool stored = false;
+        {
+            std::lock_guard lock(cache_mutex_);
+            if (generation == cache_generation_ && !cache_.valid) {
+                std::swap(cache_, resolved);
+                stored = true;
+            }
+        }
 
-    obs_sceneitem_t* CameraController::find_active_camera_item() const {
-        if (camera_names_.empty()) {
-            log(LogLevel::DEBUG, "Unable to find any camera items");
-            return nullptr;
+        // Invalidated (or resolved by another thread) in the meantime; the result is still usable once
+        if (!stored) {
+            disconnect_scene_signals(scene_source);
         }
 
-        const auto scene_source = obs_frontend_get_current_scene();
-        if (scene_source == nullptr) {
-            log(LogLevel::DEBUG, "Unable to find scene source for the camera");
-            return nullptr;
+        if (!camera_item) {
+            log_debug("Unable to find camera item: {}", error ? *error : String());
         }
+        return camera_item;
+    }
 
-        const auto scene = obs_scene_from_source(scene_source);
-        obs_source_release(scene_source); // Important: Releasing the source to prevent memory leaks!
-        if (scene == nullptr) {
-            log(LogLevel::DEBUG, "Unable to get scene for scene source");
-            return nullptr;
+    String CameraController::get_camera_value(const GetCameraValueCallback &get_value_function) const {
+        String error;
+        const auto camera = find_active_camera_item(&error);
+        if (!camera) {
+            return log_error(error);
         }
 
-        for (const auto& sourceName : camera_names_) {
-            if (obs_sceneitem_t* item = obs_scene_find_source(scene, sourceName.c_str())) {
-                return item;
-            }
+        const auto camera_source = obs_sceneitem_get_source(camera.get());
+        if (camera_source == nullptr) {
+            return log_error("ERROR: Source item for camera not found");
         }
 
-        return nullptr;
+        return get_value_function(obs_sceneitem_get_scene(camera.get()), camera.get(), camera_source);
     }
 
     void CameraController::set_camera_names(std::vector<String> names) {
-        camera_names_.clear();
-        camera_names_.insert_range(names);
+        {
+            std::lock_guard lock(cache_mutex_);
+            camera_names_.clear();
+            camera_names_.insert_range(names);
+        }
+        invalidate_cache();
 
         const auto new_camera_names= join_strings(names, [](String s) {
             return std::format("\"{}\"", s);
@@ -90,107 +214,220 @@ namespace ObsCamMove {
     }
 
     String CameraController::get_camera_name() const {
+        if (const auto names = load_names(); names && names->complete) {
+            return names->camera_name[0] != '\0' ? String(names->camera_name.data()) : log_error(names->error.data());
+        }
+
         return get_camera_value([](obs_scene_t*, obs_sceneitem_t*, const obs_source_t* camera_source) {
             return obs_source_get_name(camera_source);
         });
     }
 
-    void CameraController::move_to(const int x, const int y, const int duration, const u8 easing) {
-        const auto cameraItem = find_active_camera_item();
-        if (cameraItem == nullptr) {
-            log(LogLevel::WARN, "Can't find active camera; moving is not possible!");
-            return;
+    SceneItemRef CameraController::find_scene_item(const String& item_name) const {
+        if (item_name.empty()) {
+            return find_active_camera_item();
+        }
+
+        SourceRef scene_source;
+        {
+            std::lock_guard lock(cache_mutex_);
+            scene_source = cache_.scene_source;
+        }
+        if (!scene_source) {
+            scene_source = SourceRef::adopt(obs_frontend_get_current_scene());
+        }
+
+        const auto scene = scene_source ? obs_scene_from_source(scene_source.get()) : nullptr;
+        if (scene == nullptr) {
+            log_debug("Unable to get scene for scene source");
+            return {};
         }
 
-        if (camera_moving_.load()) {
-            log(LogLevel::WARN, "Camera moving is already active");
+        return SceneItemRef(obs_scene_find_source(scene, item_name.c_str()));
+    }
+
+    SceneItemRef CameraController::find_animated_item(const String& item_name, const ChannelMask channels) {
+        auto* batch = AnimationBatch::current();
+        auto item = find_scene_item(item_name);
+        if (!item) {
+            const auto error = item_name.empty()
+                ? String("Can't find active camera; moving is not possible!")
+                : std::format("Can't find scene item \"{}\"; moving is not possible!", item_name);
+            log(LogLevel::WARN, error);
+            if (batch != nullptr) {
+                batch->fail(error);
+            }
+            return {};
+        }
+
+        if (item_name.empty() && (channels & POSITION_CHANNELS)) {
+            // A staged move only takes the camera over from velocity or follow control once its batch commits
+            const auto stop_control = [this] { control_mode_.store(ControlMode::None, std::memory_order_release); };
+            if (batch != nullptr) {
+                batch->on_commit(stop_control);
+            } else {
+                stop_control();
+            }
+        }
+        return item;
+    }
+
+    void CameraController::move_to(const float x, const float y, const int duration, const u8 easing, const String& item_name) {
+        const auto item = find_animated_item(item_name, POSITION_CHANNELS);
+        if (!item) {
             return;
         }
 
-        std::thread([=, this]() {
-            camera_moving_.store(true);
+        start_move(item.get(), TransformValues::from_position({ x, y }), duration, easing);
+    }
+
+    void CameraController::move_by(const float dx, const float dy, const int duration, const u8 easing, const String& item_name) {
+        const auto item = find_animated_item(item_name, POSITION_CHANNELS);
+        if (!item) {
+            return;
+        }
 
-            // Get current camera position
-            vec2 start_pos;
-            obs_sceneitem_get_pos(cameraItem, &start_pos);
+        vec2 start_pos;
+        obs_sceneitem_get_pos(item.get(), &start_pos);
 
-            float start_x = start_pos.x;
-            float start_y = start_pos.y;
+        const float target_x = start_pos.x + dx;
+        const float target_y = start_pos.y + dy;
 
-            log(LogLevel::DEBUG, std::format("Starting pos: {}, {}", start_x, start_y));
+        start_move(item.get(), TransformValues::from_position({ target_x, target_y }), duration, easing);
+    }
 
-            // Calculate distance
-            const float distance = std::sqrt(std::pow(x - start_x, 2) + std::pow(y - start_y, 2));
+    void CameraController::move_path(const std::span<const vec2> waypoints, const int duration, const u8 easing) {
+        const auto item = find_animated_item("", POSITION_CHANNELS);
+        if (!item) {
+            return;
+        }
 
-            // Retrieve FPS from OBS
-            double fps = obs_get_active_fps();
-            if (fps <= 0.0) {
-                log(LogLevel::ERROR, "Failed to retrieve FPS value from OBS. Defaulting to 60.");
-                fps = 60.0;
-            }
+        std::vector<vec2> points;
+        points.reserve(waypoints.size() + 1);
+        points.push_back({});
+        obs_sceneitem_get_pos(item.get(), &points.front());
+        points.insert(points.end(), waypoints.begin(), waypoints.end());
 
-            // Speed and FPS settings
-            constexpr float speed_per_second = 300.0f; // Pixels per Second
-            const float speed_per_frame = speed_per_second / static_cast<float>(fps);
+        // The curve and its arc-length table are built here once, not per frame
+        auto path = std::make_unique<const SplinePath>(points);
+        const vec2 target_pos = path->end();
+        start_move(item.get(), TransformValues::from_position(target_pos), duration, easing, std::move(path));
+    }
 
-            // Calculate number of steps and duration per step
-            const int steps = std::max(1, static_cast<int>(distance / speed_per_frame));
-            const float step_duration = duration / static_cast<float>(steps);
+    void CameraController::set_position(const float x, const float y, const String& item_name) {
+        move_to(x, y, 0, 0, item_name);
+    }
 
-            log(LogLevel::DEBUG, std::format("Number of steps: {}", steps));
-            log(LogLevel::DEBUG, std::format("FPS: {}", fps));
-            log(LogLevel::DEBUG, std::format("Step duration: {}", step_duration));
+    void CameraController::scale_to(const float scale_x, const float scale_y, const int duration, const u8 easing,
+                                     const String& item_name) {
+        TransformValues target;
+        target.set(TransformChannel::ScaleX, scale_x);
+        target.set(TransformChannel::ScaleY, scale_y);
+        animate(target, duration, easing, item_name);
+    }
 
-            // Convert value to easing type
-            const auto easing_type = CameraEasing::to_camera_easing_type(easing);
+    void CameraController::zoom(const float factor, const int duration, const u8 easing, const String& item_name) {
+        const auto item = find_animated_item(item_name, SCALE_CHANNELS);
+        if (!item) {
+            return;
+        }
 
-            for (int i = 0; i < steps; i++) {
-                float t = i / static_cast<float>(steps);
+        vec2 scale;
+        obs_sceneitem_get_scale(item.get(), &scale);
 
-                // Easing
-                t = CameraEasing::calculate(easing_type, t);
+        TransformValues target;
+        target.set(TransformChannel::ScaleX, scale.x * factor);
+        target.set(TransformChannel::ScaleY, scale.y * factor);
+        start_move(item.get(), target, duration, easing);
+    }
 
-                // Calculate new camera position per step
-                vec2 new_pos = {
-                    start_x + t * (x - start_x),
-                    start_y + t * (y - start_y)
-                };
+    void CameraController::rotate(const float angle, const int duration, const u8 easing, const String& item_name) {
+        TransformValues target;
+        target.set(TransformChannel::Rotation, angle);
+        animate(target, duration, easing, item_name);
+    }
 
-                // Update camera position
-                obs_sceneitem_set_pos(cameraItem, &new_pos);
+    void CameraController::crop_to(const float left, const float top, const float right, const float bottom,
+                                   const int duration, const u8 easing, const String& item_name) {
+        TransformValues target;
+        target.set(TransformChannel::CropLeft, left);
+        target.set(TransformChannel::CropTop, top);
+        target.set(TransformChannel::CropRight, right);
+        target.set(TransformChannel::CropBottom, bottom);
+        animate(target, duration, easing, item_name);
+    }
 
-                // Wait before the next step is executed
-                std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(step_duration)));
-            }
+    void CameraController::fade_in(const int duration, const u8 easing, const String& item_name) {
+        TransformValues target;
+        target.set(TransformChannel::Opacity, 1.0f);
+        animate(target, duration, easing, item_name);
+    }
 
-            camera_moving_.store(false);
-        }).detach();
+    void CameraController::fade_out(const int duration, const u8 easing, const String& item_name) {
+        TransformValues target;
+        target.set(TransformChannel::Opacity, 0.0f);
+        animate(target, duration, easing, item_name);
     }
 
-    void CameraController::move_by(const int dx, const int dy, const int duration, const u8 easing) {
-        auto cameraItem = find_active_camera_item();
-        if (cameraItem == nullptr) {
-            log(LogLevel::WARN, "Can't find active camera; moving is not possible!");
+    void CameraController::animate(const TransformValues& target, const int duration, const u8 easing,
+                                   const String& item_name) {
+        if (target.mask == 0) {
             return;
         }
 
-        if (camera_moving_.load()) {
-            log(LogLevel::WARN, "Camera moving is already active");
+        const auto item = find_animated_item(item_name, target.mask);
+        if (!item) {
             return;
         }
 
-        vec2 start_pos;
-        obs_sceneitem_get_pos(cameraItem, &start_pos);
+        start_move(item.get(), target, duration, easing);
+    }
 
-        const float start_x = start_pos.x;
-        const float start_y = start_pos.y;
-        const float target_x = start_x + dx;
-        const float target_y = start_y + dy;
+    void CameraController::set_interrupt_moves(const bool enabled) {
+        interrupt_moves_.store(enabled, std::memory_order_relaxed);
+        log(LogLevel::INFO, "Interrupting moves {}", enabled ? "enabled" : "disabled");
+    }
 
-        move_to(target_x, target_y, duration, easing);
+    void CameraController::start_move(obs_sceneitem_t* item, const TransformValues& target, const int duration,
+                                      const u8 easing, std::unique_ptr<const SplinePath> path) const {
+        // Convert value to easing type
+        const auto easing_type = CameraEasing::to_camera_easing_type(easing);
+
+        CameraAnimation animation;
+        if (target.mask & channel_bit(TransformChannel::Opacity)) {
+            String error;
+            auto opacity = get_opacity_filter(item, error);
+            if (!opacity) {
+                log(LogLevel::WARN, error);
+                if (auto* batch = AnimationBatch::current()) {
+                    batch->fail(error);
+                }
+                return;
+            }
+            animation.opacity = std::move(*opacity);
+        }
+        animation.item = item;
+        animation.start = read_transform(item, target.mask);
+        animation.target = target;
+        animation.duration_ns = static_cast<u64>(std::max(0, duration)) * 1'000'000;
+        animation.easing = easing_type;
+        animation.path = std::move(path);
+        animation.interrupt = interrupt_moves_.load(std::memory_order_relaxed);
+
+        // The animation is evaluated once per rendered frame by the scheduler
+        if (!AnimationScheduler::get_instance().schedule(std::move(animation))) {
+            log(LogLevel::WARN, std::format("Scene item \"{}\" is already moving",
+                obs_source_get_name(obs_sceneitem_get_source(item))));
+        }
     }
 
     String CameraController::get_position() const {
+        if (const auto state = load_state()) {
+            return state->has_camera
+                ? std::format("camera-position: x={}, y={}", state->position.x, state->position.y)
+                : get_state_error();
+        }
+
         return get_camera_value([](obs_scene*, const obs_sceneitem_t* camera, const obs_source_t*) {
             obs_transform_info transform;
             obs_sceneitem_get_info2(camera, &transform);
@@ -199,4 +436,321 @@ namespace ObsCamMove {
             return std::format("camera-position: x={}, y={}", x, y);
         });
     }
+
+    String CameraController::get_scale() const {
+        if (const auto state = load_state()) {
+            return state->has_camera
+                ? std::format("camera-scale: x={}, y={}", state->scale.x, state->scale.y)
+                : get_state_error();
+        }
+
+        return get_camera_value([](obs_scene*, const obs_sceneitem_t* camera, const obs_source_t*) {
+            vec2 scale;
+            obs_sceneitem_get_scale(camera, &scale);
+            return std::format("camera-scale: x={}, y={}", scale.x, scale.y);
+        });
+    }
+
+    String CameraController::get_state_error() const {
+        const auto names = load_names();
+        return log_error(names ? String(names->error.data()) : "No camera in current scene found!");
+    }
+
+    String CameraController::get_camera_state() const {
+        auto state = load_state();
+        auto names = load_names();
+        if (!state || !names || !names->complete || names->generation != state->generation) {
+            // Stale: read them the way the next frame will publish them
+            state.emplace();
+            names.emplace();
+            read_state(*state, &*names);
+        }
+        if (!state->has_camera) {
+            return log_error(names->error.data());
+        }
+
+        return std::format("camera-state: scene={}, camera={}, x={}, y={}, scale_x={}, scale_y={}, moving={}, progress={}",
+            names->scene_name.data(), names->camera_name.data(), state->position.x, state->position.y,
+            state->scale.x, state->scale.y, state->moving, state->progress);
+    }
+
+    std::optional<CameraState> CameraController::get_state(String& error) const {
+        auto state = load_state();
+        if (state && !state->has_camera) {
+            error = get_state_error();
+            return std::nullopt;
+        }
+        if (!state) {
+            CameraNames names;
+            state.emplace();
+            read_state(*state, &names);
+            if (!state->has_camera) {
+                error = log_error(names.error.data());
+                return std::nullopt;
+            }
+        }
+        return state;
+    }
+
+    void CameraController::read_state(CameraState& state, CameraNames* names) const {
+        state.valid = true;
+        // Read before the camera, so an invalidation in between leaves the state stale rather than wrong
+        state.generation = cache_generation_.load(std::memory_order_acquire);
+        if (names) {
+            names->valid = true;
+            names->generation = state.generation;
+        }
+
+        // Like find_active_camera_item, but without logging every frame while there is no camera
+        SceneItemRef camera;
+        bool cached;
+        {
+            std::lock_guard lock(cache_mutex_);
+            cached = cache_.valid;
+            if (cached) {
+                camera = cache_.camera_item;
+                if (names) copy_name(names->error, cache_.error.c_str());
+            }
+        }
+        if (!cached) {
+            String error;
+            camera = find_active_camera_item(&error);
+            if (names) copy_name(names->error, error.c_str());
+        }
+
+        const auto camera_source = camera ? obs_sceneitem_get_source(camera.get()) : nullptr;
+        if (camera_source == nullptr) {
+            if (camera && names) {
+                copy_name(names->error, "Source item for camera not found");
+            }
+            return;
+        }
+
+        state.has_camera = true;
+        obs_sceneitem_get_pos(camera.get(), &state.position);
+        obs_sceneitem_get_scale(camera.get(), &state.scale);
+        const float progress = AnimationScheduler::get_instance().get_progress(camera.get());
+        state.progress = std::max(progress, 0.0f);
+        state.moving = progress >= 0.0f || control_moving_.load(std::memory_order_relaxed);
+
+        if (names) {
+            names->complete = copy_name(names->camera_name, obs_source_get_name(camera_source));
+            const auto scene_source = obs_scene_get_source(obs_sceneitem_get_scene(camera.get()));
+            names->complete &= copy_name(names->scene_name, scene_source ? obs_source_get_name(scene_source) : nullptr);
+        }
+    }
+
+    void CameraController::publish_state() {
+        CameraState state;
+        if (cache_generation_.load(std::memory_order_acquire) == names_generation_) {
+            read_state(state, nullptr);
+        } else {
+            // Cold path after a change of the scene or the camera names
+            CameraNames names;
+            read_state(state, &names);
+            names_.store(names);
+            names_generation_ = names.generation;
+        }
+        state_.store(state);
+    }
+
+    std::optional<CameraState> CameraController::load_state() const {
+        const CameraState state = state_.load();
+        if (!state.valid || state.generation != cache_generation_.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+        return state;
+    }
+
+    std::optional<CameraNames> CameraController::load_names() const {
+        const CameraNames names = names_.load();
+        if (!names.valid || names.generation != cache_generation_.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+        return names;
+    }
+
+    bool CameraController::get_position(vec2& position) const {
+        const auto camera = find_active_camera_item();
+        if (!camera) {
+            return false;
+        }
+
+        obs_sceneitem_get_pos(camera.get(), &position);
+        return true;
+    }
+
+    void CameraController::set_velocity(const float vx, const float vy) {
+        set_control_input(ControlMode::Velocity, { vx, vy });
+    }
+
+    void CameraController::set_target(const float x, const float y) {
+        set_control_input(ControlMode::Target, { x, y });
+    }
+
+    void CameraController::set_motion_limits(const float max_speed, const float max_acceleration) {
+        max_speed_.store(std::max(0.0f, max_speed), std::memory_order_relaxed);
+        max_acceleration_.store(std::max(0.0f, max_acceleration), std::memory_order_relaxed);
+        log(LogLevel::INFO, "Motion limits set: max. speed {} px/s, max. acceleration {} px/s²",
+            max_speed, max_acceleration);
+    }
+
+    void CameraController::follow(const String& target_name, const vec2 offset, const float dead_zone,
+                                  const float stiffness) {
+        {
+            std::lock_guard lock(follow_mutex_);
+            follow_ = {};
+            follow_.target_name = target_name;
+            follow_.offset = offset;
+            follow_.dead_zone = std::max(0.0f, dead_zone);
+            follow_.stiffness = std::max(0.0f, stiffness);
+        }
+        control_input_time_ns_.store(steady_now_ns(), std::memory_order_relaxed);
+        control_mode_.store(ControlMode::Follow, std::memory_order_release);
+        log(LogLevel::INFO, "Following \"{}\" at offset {}, {} (dead zone {} px, stiffness {}/s)",
+            target_name, offset.x, offset.y, dead_zone, stiffness);
+    }
+
+    void CameraController::stop_follow() {
+        auto mode = ControlMode::Follow;
+        control_mode_.compare_exchange_strong(mode, ControlMode::None, std::memory_order_acq_rel);
+    }
+
+    void CameraController::set_control_input(const ControlMode mode, const vec2 value) {
+        control_input_.store(pack_vec2(value), std::memory_order_relaxed);
+        control_input_time_ns_.store(steady_now_ns(), std::memory_order_relaxed);
+        control_mode_.store(mode, std::memory_order_release);
+    }
+
+    void CameraController::on_video_tick(void* param, const float seconds) {
+        const auto controller = static_cast<CameraController*>(param);
+        controller->integrate_control(seconds);
+        controller->control_moving_.store(controller->control_velocity_.x != 0.0f || controller->control_velocity_.y != 0.0f,
+                                          std::memory_order_relaxed);
+        // Registered after the animation scheduler, so the state includes this frame's moves
+        controller->publish_state();
+    }
+
+    void CameraController::integrate_control(const float seconds) {
+        const auto mode = control_mode_.load(std::memory_order_acquire);
+        if (mode == ControlMode::None || seconds <= 0.0f) {
+            control_velocity_ = {};
+            return;
+        }
+
+        const auto camera = find_active_camera_item();
+        if (!camera || AnimationScheduler::get_instance().is_animating(camera.get(), POSITION_CHANNELS)) {
+            control_velocity_ = {};
+            return;
+        }
+
+        const float max_speed = max_speed_.load(std::memory_order_relaxed);
+        const float max_acceleration = max_acceleration_.load(std::memory_order_relaxed);
+        const vec2 input = unpack_vec2(control_input_.load(std::memory_order_relaxed));
+
+        vec2 pos;
+        obs_sceneitem_get_pos(camera.get(), &pos);
+
+        if (mode == ControlMode::Follow) {
+            integrate_follow(camera.get(), pos, seconds);
+            return;
+        }
+
+        vec2 desired = {};
+        float distance = 0.0f;
+        if (mode == ControlMode::Velocity) {
+            const auto input_age_ns = steady_now_ns() - control_input_time_ns_.load(std::memory_order_relaxed);
+            if (input_age_ns <= std::chrono::nanoseconds(VELOCITY_INPUT_TIMEOUT).count()) {
+                desired = input;
+                if (const float speed = std::hypot(desired.x, desired.y); speed > max_speed) {
+                    desired.x *= max_speed / speed;
+                    desired.y *= max_speed / speed;
+                }
+            }
+        } else {
+            const vec2 offset = { input.x - pos.x, input.y - pos.y };
+            distance = std::hypot(offset.x, offset.y);
+            if (distance > 0.0f) {
+                // Fastest speed from which the camera can still brake to a stop at the target
+                const float speed = std::min(max_speed, std::sqrt(2.0f * max_acceleration * distance));
+                desired = { offset.x / distance * speed, offset.y / distance * speed };
+            }
+        }
+
+        // Change the velocity towards the desired one by at most the acceleration limit
+        vec2 change = { desired.x - control_velocity_.x, desired.y - control_velocity_.y };
+        const float max_change = max_acceleration * seconds;
+        if (const float length = std::hypot(change.x, change.y); length > max_change) {
+            change.x *= max_change / length;
+            change.y *= max_change / length;
+        }
+        control_velocity_.x += change.x;
+        control_velocity_.y += change.y;
+
+        if (control_velocity_.x == 0.0f && control_velocity_.y == 0.0f) {
+            return;
+        }
+
+        vec2 new_pos = { pos.x + control_velocity_.x * seconds, pos.y + control_velocity_.y * seconds };
+        if (mode == ControlMode::Target
+            && std::hypot(control_velocity_.x, control_velocity_.y) * seconds >= distance) {
+            // Land on the target instead of overshooting it in the last frame
+            new_pos = input;
+            control_velocity_ = {};
+        }
+        if (auto& constraints = MotionConstraints::get_instance(); constraints.is_active()) {
+            new_pos = constraints.constrain(camera.get(), pos, new_pos);
+        }
+        obs_sceneitem_set_pos(camera.get(), &new_pos);
+    }
+
+    void CameraController::integrate_follow(obs_sceneitem_t* camera, const vec2 pos, const float seconds) {
+        std::lock_guard lock(follow_mutex_);
+        u64 generation;
+        {
+            std::lock_guard cache_lock(cache_mutex_);
+            generation = cache_generation_;
+        }
+        if (!follow_.resolved || follow_.cache_generation != generation) {
+            // Cold path after a scene change; otherwise the target is read without searching the scene
+            follow_.target = find_scene_item(follow_.target_name);
+            follow_.cache_generation = generation;
+            follow_.resolved = true;
+        }
+        if (!follow_.target || follow_.target.get() == camera) {
+            control_velocity_ = {};
+            return;
+        }
+
+        // The target is read in the same tick that moves the webcam, after the animations of this frame
+        vec2 target_pos;
+        obs_sceneitem_get_pos(follow_.target.get(), &target_pos);
+        vec2 goal = { target_pos.x + follow_.offset.x, target_pos.y + follow_.offset.y };
+
+        // Within the dead zone the webcam settles where it is; outside it is pulled to its edge
+        const vec2 error = { goal.x - pos.x, goal.y - pos.y };
+        const float distance = std::hypot(error.x, error.y);
+        if (distance <= follow_.dead_zone) {
+            goal = pos;
+        } else if (follow_.dead_zone > 0.0f) {
+            const float scale = follow_.dead_zone / distance;
+            goal = { goal.x - error.x * scale, goal.y - error.y * scale };
+        }
+
+        // Exact step of the critically damped spring x'' = -ω²x - 2ωx', so it is stable at any frame rate
+        const float omega = follow_.stiffness;
+        const float decay = std::exp(-omega * seconds);
+        const vec2 offset = { pos.x - goal.x, pos.y - goal.y };
+        const vec2 temp = { (control_velocity_.x + omega * offset.x) * seconds,
+                            (control_velocity_.y + omega * offset.y) * seconds };
+        control_velocity_ = { (control_velocity_.x - omega * temp.x) * decay,
+                              (control_velocity_.y - omega * temp.y) * decay };
+        vec2 new_pos = { goal.x + (offset.x + temp.x) * decay, goal.y + (offset.y + temp.y) * decay };
+        if (auto& constraints = MotionConstraints::get_instance(); constraints.is_active()) {
+            new_pos = constraints.constrain(camera, pos, new_pos);
+        }
+        if (new_pos.x != pos.x || new_pos.y != pos.y) {
+            obs_sceneitem_set_pos(camera, &new_pos);
+        }
+    }
 }
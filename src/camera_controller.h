@@ -1,13 +1,48 @@
 #pragma once
 
 #include "prerequisites.h"
+#include "obs_ref.h"
+#include "seqlock.h"
+#include "spline_path.h"
+#include "transform_channels.h"
+#include <array>
+#include <mutex>
+#include <span>
 #include <unordered_set>
 #include <string>
 #include <tuple>
 #include <atomic>
+#include <chrono>
+#include <optional>
 #include <obs-module.h>
+#include <obs-frontend-api.h>
 
 namespace ObsCamMove {
+    //! State of the webcam as of the last rendered frame. The video tick publishes it, so that queries
+    //! can answer from it without calling into libobs.
+    struct CameraState {
+        u64 generation = 0;      // Camera cache generation it was read with; stale once that changes
+        bool valid = false;      // False before the first frame and after stop()
+        bool has_camera = false; // Otherwise CameraNames::error tells why
+        bool moving = false;     // Animated or under continuous control
+        vec2 position = {};
+        vec2 scale = {};
+        float progress = 0.0f;   // Of the running animation, 0 to 1
+    };
+
+    //! Names that go with CameraState. They only change with the camera cache generation, so the video tick
+    //! publishes them only then, and queries for the position do not copy them.
+    struct CameraNames {
+        static constexpr usize NAME_SIZE = 128;
+
+        u64 generation = 0;
+        bool valid = false;
+        bool complete = true; // False if a name did not fit; queries then ask libobs
+        std::array<char, NAME_SIZE> scene_name{};
+        std::array<char, NAME_SIZE> camera_name{};
+        std::array<char, NAME_SIZE> error{};
+    };
+
     class CameraController {
     public:
         static CameraController& getInstance() {
@@ -15,57 +50,181 @@ namespace ObsCamMove {
             return instance;
         }
 
+        //! Registers the frontend and signal callbacks that invalidate the cached camera item,
+        //! and the video tick that integrates continuous camera control.
+        void start();
+        void stop();
+
         void set_camera_names(std::vector<String> names);
         String get_camera_name() const;
 
         //! Moves the webcam to the specified position (x, y) over the specified duration in milliseconds.
-        void move_to(int x, int y, int duration, u8 easing = 0);
+        //! If item_name is given, that scene item of the current scene is moved instead of the webcam.
+        void move_to(float x, float y, int duration, u8 easing = 0, const String& item_name = "");
         //! Moves the webcam relative to the current position by (dx, dy) over the specified duration.
-        void move_by(int dx, int dy, int duration, u8 easing = 0);
+        void move_by(float dx, float dy, int duration, u8 easing = 0, const String& item_name = "");
+        //! Moves the webcam through the waypoints along a smooth curve at even speed; the easing is applied
+        //! to the distance travelled along the curve.
+        void move_path(std::span<const vec2> waypoints, int duration, u8 easing = 0);
+        //! Places the webcam (or the named item) at (x, y) with the next rendered frame.
+        void set_position(float x, float y, const String& item_name = "");
+
+        // Transform animations share the timing and easing of the moves and run in the same per-frame pass,
+        // so a zoom and a pan of the same item started together (in one animate or batch) stay in sync.
+
+        //! Animates the scale of the webcam (or the named item) to the given factors.
+        void scale_to(float scale_x, float scale_y, int duration, u8 easing = 0, const String& item_name = "");
+        //! Multiplies the current scale by factor over the duration.
+        void zoom(float factor, int duration, u8 easing = 0, const String& item_name = "");
+        //! Rotates to the given angle in degrees, clockwise.
+        void rotate(float angle, int duration, u8 easing = 0, const String& item_name = "");
+        //! Animates the crop of each edge to the given amount in pixels.
+        void crop_to(float left, float top, float right, float bottom, int duration, u8 easing = 0,
+                     const String& item_name = "");
+        //! Fades the opacity to 1 (fully visible) or 0 (transparent).
+        void fade_in(int duration, u8 easing = 0, const String& item_name = "");
+        void fade_out(int duration, u8 easing = 0, const String& item_name = "");
+        //! Animates any combination of channels (those in target.mask) together.
+        void animate(const TransformValues& target, int duration, u8 easing = 0, const String& item_name = "");
+
+        //! If enabled, a move of an item that is already moving replaces the running move, starting from
+        //! the current position and velocity. Otherwise the new move is rejected (default).
+        void set_interrupt_moves(bool enabled);
+
+        // Continuous control for input streamed at a high rate (gamepad, face tracker): each call replaces
+        // the previous value, which the video tick applies from the next frame on. Lock-free and without
+        // allocation; a move_to/move_by of the webcam ends it.
+
+        //! Moves the webcam with the given velocity in pixels per second.
+        void set_velocity(float vx, float vy);
+        //! Moves the webcam towards (x, y) as fast as the motion limits allow and stops there.
+        void set_target(float x, float y);
+        //! Limits the speed (pixels/s) and acceleration (pixels/s²) of the continuous control.
+        void set_motion_limits(float max_speed, float max_acceleration);
+        //! Keeps the webcam at offset from the named scene item, pulled by a critically damped spring with the
+        //! given stiffness (1/s; it settles in about 5 / stiffness seconds without overshooting). The webcam
+        //! stays put while the target is within dead_zone pixels of where it should be.
+        void follow(const String& target_name, vec2 offset, float dead_zone, float stiffness);
+        //! Ends following; like the other continuous control, also ended by a move of the webcam.
+        void stop_follow();
 
         /**
-        void follow(std::string objectId, int duration, bool reset);
         void stop_movement();
         bool is_moving() const;
 
-        void scale_to(int width, int heigth, int duration);
-        void zoom(int factor, int duration);
-
-        void fade_in(int duration);
-        void fade_out(int duration);
         void show();
         void hide();
         **/
 
+        // The queries answer from the state published by the last frame. They only fall back to libobs while
+        // the state is stale: before the first frame and until the frame after a change of the scene or
+        // the camera names.
+
         String get_position() const;
+        //! Position of the webcam without formatting or logging; false if there is no webcam in the scene.
+        bool get_position(vec2& position) const;
+        String get_scale() const;
+        //! Scene, camera, position, scale and the progress of its animation in one reply.
+        String get_camera_state() const;
+        //! The same state without formatting, for the binary protocol; nullopt if there is no webcam in the
+        //! scene, with the logged error reply in error.
+        std::optional<CameraState> get_state(String& error) const;
 
         /**
-        std::tuple<int, int> get_scale() const;
         bool get_visibility() const;
 
-        void set_bounds(int min_x, int min_y, int max_x, int max_y);
         void set_speed(int speed);
         void set_easing(CameraEasingType easing);
-        void set_position(int x, int y);
 
-        void rotate(int angle, int duration, bool reset);
         void reset();
-        void lock_position(bool lock);
         **/
 
     private:
         typedef std::function<String(obs_scene_t*, obs_sceneitem_t*, obs_source_t*)> GetCameraValueCallback;
 
+        //! Camera item resolved for the current scene; valid until a scene or item change invalidates it.
+        struct CameraCache {
+            SourceRef scene_source;   // Holds the item_add/item_remove signal connections
+            SceneItemRef camera_item; // Null if the scene has no camera; error tells why
+            String error;
+            bool valid = false;
+        };
+
+        enum class ControlMode : u8 {
+            None,
+            Velocity,
+            Target,
+            Follow,
+        };
+
+        //! Parameters of follow(); the target item is resolved again after each change of the scene.
+        struct FollowState {
+            String target_name;
+            SceneItemRef target;
+            u64 cache_generation = 0;
+            bool resolved = false;
+            vec2 offset = {};
+            float dead_zone = 0.0f;
+            float stiffness = 0.0f;
+        };
+
+        //! Velocity input is dropped after this long without an update, so a lost client does not
+        //! leave the camera drifting.
+        static constexpr auto VELOCITY_INPUT_TIMEOUT = std::chrono::milliseconds(500);
+
         std::unordered_set<std::string> camera_names_;
-        std::atomic<bool> camera_moving_;
+        mutable std::mutex cache_mutex_;
+        mutable CameraCache cache_;
+        mutable std::atomic<u64> cache_generation_ = 0; // Written under cache_mutex_, read lock-free by queries
+        SeqLock<CameraState> state_;
+        SeqLock<CameraNames> names_;
+        u64 names_generation_ = UINT64_MAX; // Generation of the published names; only used by the video tick
+
+        // Latest control input; both coordinates are packed into one atomic so they never tear
+        std::atomic<ControlMode> control_mode_ = ControlMode::None;
+        std::atomic<u64> control_input_ = 0;
+        std::atomic<i64> control_input_time_ns_ = 0;
+        std::atomic<float> max_speed_ = 2000.0f;
+        std::atomic<float> max_acceleration_ = 8000.0f;
+        std::atomic_bool interrupt_moves_ = false;
+        vec2 control_velocity_ = {}; // Only used by the video tick
+        std::atomic_bool control_moving_ = false; // control_velocity_ is not zero, for other threads
+        std::mutex follow_mutex_;
+        FollowState follow_;
 
         CameraController();
 
         static String log_error(const String& error_message);
-        static obs_scene_t* find_active_scene();
+
+        static void on_frontend_event(obs_frontend_event event, void* param);
+        static void on_scene_signal(void* param, calldata_t* data);
+        static void on_video_tick(void* param, float seconds);
+        void integrate_control(float seconds);
+        void integrate_follow(obs_sceneitem_t* camera, vec2 pos, float seconds);
+        //! Reads the state of the webcam from libobs, and its names if names is not null.
+        void read_state(CameraState& state, CameraNames* names) const;
+        //! Publishes the state of the webcam after all updates of the frame, and its names if they changed.
+        void publish_state();
+        //! The published state or names if they are still current.
+        [[nodiscard]] std::optional<CameraState> load_state() const;
+        [[nodiscard]] std::optional<CameraNames> load_names() const;
+        //! Error reply for a query while the published state has no camera.
+        [[nodiscard]] String get_state_error() const;
+        void set_control_input(ControlMode mode, vec2 value);
+        void invalidate_cache() const;
+        void disconnect_scene_signals(obs_source_t* scene_source) const;
+        CameraCache resolve_camera_cache(const std::vector<String>& camera_names) const;
 
         String get_camera_value(const GetCameraValueCallback &get_value_function) const;
 
-        obs_sceneitem_t* find_active_camera_item() const;
+        SceneItemRef find_active_camera_item(String* error = nullptr) const;
+        SceneItemRef find_scene_item(const String& item_name) const;
+
+        //! Finds the scene item to animate and ends the continuous control if its position is animated;
+        //! null (after logging a warning) if there is no such item.
+        SceneItemRef find_animated_item(const String& item_name, ChannelMask channels);
+        //! Animates the channels in target.mask from their current values.
+        void start_move(obs_sceneitem_t* item, const TransformValues& target, int duration, u8 easing,
+                        std::unique_ptr<const SplinePath> path = nullptr) const;
     };
 }
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "prerequisites.h"
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <span>
 
 namespace ObsCamMove {
     enum class CameraEasingType : uint8_t {
@@ -18,6 +21,69 @@ namespace ObsCamMove {
         EaseInOutElastic = 10,
     };
 
+    namespace EasingDetail {
+        constexpr usize EASING_TABLE_SIZE = 1024;
+        using EasingTable = std::array<float, EASING_TABLE_SIZE + 1>;
+
+        // std::sin and std::pow are not constexpr, so the tables are built with these series expansions
+        constexpr double const_sin(double x) {
+            constexpr double pi = 3.14159265358979323846;
+            while (x > pi) x -= 2 * pi;
+            while (x < -pi) x += 2 * pi;
+
+            double term = x;
+            double sum = x;
+            for (int n = 1; n < 20; n++) {
+                term *= -x * x / ((2 * n) * (2 * n + 1));
+                sum += term;
+            }
+            return sum;
+        }
+
+        constexpr double const_exp2(const double x) {
+            constexpr double ln2 = 0.69314718055994530942;
+            auto whole = static_cast<int>(x);
+            if (static_cast<double>(whole) > x) whole--;
+            const double fraction = (x - whole) * ln2;
+
+            double term = 1.0;
+            double sum = 1.0;
+            for (int n = 1; n < 20; n++) {
+                term *= fraction / n;
+                sum += term;
+            }
+            for (; whole > 0; whole--) sum *= 2;
+            for (; whole < 0; whole++) sum /= 2;
+            return sum;
+        }
+
+        template<typename Function>
+        constexpr EasingTable build_table(Function function) {
+            EasingTable table{};
+            for (usize i = 0; i <= EASING_TABLE_SIZE; i++) {
+                table[i] = static_cast<float>(function(static_cast<double>(i) / EASING_TABLE_SIZE));
+            }
+            return table;
+        }
+
+        inline constexpr EasingTable EASE_IN_ELASTIC_TABLE = build_table([](const double t) {
+            constexpr double c4 = (2 * 3.14159265358979323846) / 3;
+            return -const_exp2(10 * t - 10) * const_sin((t * 10 - 10.75) * c4);
+        });
+
+        inline constexpr EasingTable EASE_OUT_ELASTIC_TABLE = build_table([](const double t) {
+            constexpr double c4 = (2 * 3.14159265358979323846) / 3;
+            return const_exp2(-10 * t) * const_sin((t * 10 - 0.75) * c4) + 1;
+        });
+
+        inline constexpr EasingTable EASE_IN_OUT_ELASTIC_TABLE = build_table([](const double t) {
+            constexpr double c5 = (2 * 3.14159265358979323846) / 4.5;
+            return (t < 0.5)
+                ? -(const_exp2(20 * t - 10) * const_sin((20 * t - 11.125) * c5)) / 2
+                : (const_exp2(-20 * t + 10) * const_sin((20 * t - 11.125) * c5)) / 2 + 1;
+        });
+    }
+
     class CameraEasing {
     public:
         static CameraEasingType to_camera_easing_type(const u8 easing_type_value) {
@@ -54,7 +120,70 @@ namespace ObsCamMove {
             }
         }
 
+        //! Evaluates the easing for every value in t and writes the results to out (same size as t).
+        //! Polynomial curves are computed directly in a vectorizable loop; the elastic curves are
+        //! sampled from compile-time lookup tables with linear interpolation (max. error < 1e-4).
+        static void calculate(const CameraEasingType type, const std::span<const float> t, const std::span<float> out) {
+            const usize count = std::min(t.size(), out.size());
+            switch (type) {
+                case CameraEasingType::SmoothStep:
+                    for (usize i = 0; i < count; i++) out[i] = t[i] * t[i] * (3 - 2 * t[i]);
+                    break;
+                case CameraEasingType::EaseInQuad:
+                    for (usize i = 0; i < count; i++) out[i] = t[i] * t[i];
+                    break;
+                case CameraEasingType::EaseOutQuad:
+                    for (usize i = 0; i < count; i++) out[i] = t[i] * (2 - t[i]);
+                    break;
+                case CameraEasingType::EaseInOutQuad:
+                    for (usize i = 0; i < count; i++) {
+                        out[i] = t[i] < 0.5f ? 2 * t[i] * t[i] : -1 + (4 - 2 * t[i]) * t[i];
+                    }
+                    break;
+                case CameraEasingType::EaseInQuint:
+                    for (usize i = 0; i < count; i++) out[i] = pow5(t[i]);
+                    break;
+                case CameraEasingType::EaseOutQuint:
+                    for (usize i = 0; i < count; i++) out[i] = 1 - pow5(1 - t[i]);
+                    break;
+                case CameraEasingType::EaseInOutQuint:
+                    for (usize i = 0; i < count; i++) {
+                        out[i] = t[i] < 0.5f ? 16 * pow5(t[i]) : 1 - pow5(-2 * t[i] + 2) / 2;
+                    }
+                    break;
+                case CameraEasingType::EaseInElastic:
+                    sample_table(EasingDetail::EASE_IN_ELASTIC_TABLE, t.first(count), out);
+                    break;
+                case CameraEasingType::EaseOutElastic:
+                    sample_table(EasingDetail::EASE_OUT_ELASTIC_TABLE, t.first(count), out);
+                    break;
+                case CameraEasingType::EaseInOutElastic:
+                    sample_table(EasingDetail::EASE_IN_OUT_ELASTIC_TABLE, t.first(count), out);
+                    break;
+                default:
+                    std::copy_n(t.begin(), count, out.begin());
+                    break;
+            }
+        }
+
     private:
+        static constexpr float pow5(const float x) {
+            const float x2 = x * x;
+            return x2 * x2 * x;
+        }
+
+        static void sample_table(const EasingDetail::EasingTable& table, const std::span<const float> t, const std::span<float> out) {
+            for (usize i = 0; i < t.size(); i++) {
+                const float x = std::clamp(t[i], 0.0f, 1.0f) * EasingDetail::EASING_TABLE_SIZE;
+                const usize index = std::min(static_cast<usize>(x), EasingDetail::EASING_TABLE_SIZE - 1);
+                const float fraction = x - static_cast<float>(index);
+                const float value = table[index] * (1 - fraction) + table[index + 1] * fraction;
+
+                // The tables hold the continuous curve; like the scalar formulas, the endpoints are exact
+                out[i] = t[i] <= 0.0f ? 0.0f : (t[i] >= 1.0f ? 1.0f : value);
+            }
+        }
+
         static float ease_in_elastic(const float t) {
             constexpr auto c4 = (2 * M_PI) / 3;
 
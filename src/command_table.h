@@ -0,0 +1,69 @@
+#pragma once
+
+#include "prerequisites.h"
+#include <array>
+#include <bit>
+
+namespace ObsCamMove {
+    //! Perfect hash over a fixed set of names, built at compile time. A lookup hashes the length and
+    //! three characters of the name, reads one slot and compares one name. The hash seed is searched by
+    //! the constructor, so a set of names it can not tell apart fails to compile.
+    template<usize N>
+    class StaticCommandTable {
+    public:
+        static_assert(N > 0 && N < 255, "The slots store the name index as u8");
+
+        //! At least four slots per name keep the seed search short.
+        static constexpr u32 SLOT_BITS = static_cast<u32>(std::bit_width(N * 4 - 1));
+        static constexpr usize SLOT_COUNT = usize{1} << SLOT_BITS;
+
+        consteval explicit StaticCommandTable(const std::array<StringView, N>& names) : names_(names) {
+            for (u32 seed = 0x9E3779B1u; seed != 0x9E3779B1u + 2 * 100'000; seed += 2) {
+                if (try_seed(seed)) {
+                    return;
+                }
+            }
+            throw "No collision-free hash seed found; extend key() to tell the command names apart";
+        }
+
+        //! Index of the name in the array the table was built from, or N if it is not part of it.
+        [[nodiscard]] constexpr usize find(const StringView name) const {
+            const u8 index = slots_[slot(name, seed_)];
+            return index != EMPTY && names_[index] == name ? index : N;
+        }
+
+    private:
+        static constexpr u8 EMPTY = 0xFF;
+
+        std::array<StringView, N> names_;
+        std::array<u8, SLOT_COUNT> slots_{};
+        u32 seed_ = 0;
+
+        static constexpr u32 key(const StringView name) {
+            if (name.empty()) {
+                return 0;
+            }
+            return static_cast<u32>(name.size())
+                | static_cast<u32>(static_cast<u8>(name.front())) << 8
+                | static_cast<u32>(static_cast<u8>(name[name.size() / 2])) << 16
+                | static_cast<u32>(static_cast<u8>(name.back())) << 24;
+        }
+
+        static constexpr usize slot(const StringView name, const u32 seed) {
+            return static_cast<usize>((key(name) * seed) >> (32 - SLOT_BITS));
+        }
+
+        consteval bool try_seed(const u32 seed) {
+            slots_.fill(EMPTY);
+            for (usize i = 0; i < N; i++) {
+                u8& entry = slots_[slot(names_[i], seed)];
+                if (entry != EMPTY) {
+                    return false;
+                }
+                entry = static_cast<u8>(i);
+            }
+            seed_ = seed;
+            return true;
+        }
+    };
+}
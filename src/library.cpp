@@ -1,11 +1,19 @@
 #include "library.h"
 #include "tcp_server.h"
+#include "shared_memory_transport.h"
+#include "animation_scheduler.h"
+#include "camera_controller.h"
+#include "motion_constraints.h"
+#include "position_publisher.h"
+#include "session_recording.h"
 #include "logger.h"
 #include "env_var.h"
+#include <algorithm>
 #include <mutex>
 namespace ocm = ObsCamMove;
 
 std::unique_ptr<ObsCamMove::TCPServer> tcp_server;
+std::unique_ptr<ObsCamMove::SharedMemoryServer> shared_memory_server;
 std::atomic_bool obs_module_loaded(false);
 std::mutex obs_module_lock;
 
@@ -45,6 +53,7 @@ bool obs_module_load() {
 
     if (!create_global_mutex()) {
         ocm::log(ocm::LogLevel::ERROR, "Failed to create global mutex. Plugin will not load.");
+        ocm::Logger::get_instance().shutdown(); // Unload is not called for a module that failed to load
         return false;
     }
 
@@ -54,14 +63,38 @@ bool obs_module_load() {
     }
 
     try {
+        ocm::Logger::get_instance().set_min_level(ocm::to_log_level(ocm::get_env_var("OBS_CAMERA_MOVE_LOG_LEVEL")));
         ocm::log(ocm::LogLevel::INFO, "**** OBS Camera Move loading ****");
         const auto tcp_port = ocm::get_env_var_int("OBS_CAMERA_MOVE_PORT", 5680);
-        tcp_server = std::make_unique<ocm::TCPServer>(tcp_port);
+        const auto framing_mode = ocm::to_framing_mode(ocm::get_env_var("OBS_CAMERA_MOVE_FRAMING"));
+        const auto io_threads = ocm::get_env_var_int("OBS_CAMERA_MOVE_IO_THREADS", 2);
+        if (const auto record_path = ocm::get_env_var("OBS_CAMERA_MOVE_RECORD"); !record_path.empty()) {
+            ocm::SessionRecorder::get_instance().start(record_path); // Replayed with bench/load_generator
+        }
+        // Both transports are created before either starts, so a failure leaves no thread running
+        const auto socket_path = ocm::get_env_var("OBS_CAMERA_MOVE_SOCKET"); // Unix domain socket for local clients
+        tcp_server = std::make_unique<ocm::TCPServer>(tcp_port, framing_mode, static_cast<ocm::usize>(std::max(1, io_threads)),
+                                                      socket_path);
+        if (const auto shm_name = ocm::get_env_var("OBS_CAMERA_MOVE_SHM"); !shm_name.empty()) {
+            shared_memory_server = std::make_unique<ocm::SharedMemoryServer>(shm_name);
+        }
         tcp_server->start();
+        if (shared_memory_server) {
+            shared_memory_server->start();
+        }
+        ocm::AnimationScheduler::get_instance().start();
+        ocm::CameraController::getInstance().start();
+        ocm::MotionConstraints::get_instance().start();
+        ocm::PositionPublisher::get_instance().start(); // After the others, so it sees this frame's position
         obs_module_loaded.store(true);
         ocm::log(ocm::LogLevel::INFO, "OBS Camera Move loaded successfully!");
     } catch (const std::exception &e) {
         ocm::log(ocm::LogLevel::ERROR, std::string("Exception occurred while loading plugin: ") + e.what());
+        // Unload is not called for a module that failed to load
+        shared_memory_server.reset();
+        tcp_server.reset();
+        ocm::SessionRecorder::get_instance().stop();
+        ocm::Logger::get_instance().shutdown();
         return false;
     }
 
@@ -76,25 +109,40 @@ void obs_module_unload() {
     static bool already_unloaded = false;
     if (already_unloaded) {
         ocm::log(ocm::LogLevel::INFO, "obs_module_unload already processed, skipping.");
+        ocm::Logger::get_instance().shutdown();
         return ;
     }
     already_unloaded = true;
 
     if (!obs_module_loaded.load()) {
         ocm::log(ocm::LogLevel::INFO, "OBS Camera Move is already unloaded.");
+        ocm::Logger::get_instance().shutdown();
         return;
     }
 
     try {
+        ocm::PositionPublisher::get_instance().stop();
+        ocm::AnimationScheduler::get_instance().stop();
+        ocm::CameraController::getInstance().stop();
+        ocm::MotionConstraints::get_instance().stop();
+
+        if (shared_memory_server) {
+            shared_memory_server->stop();
+            shared_memory_server.reset();
+        }
+
         if (tcp_server) {
             ocm::log(ocm::LogLevel::INFO, "TCP Server is being stopped.");
             tcp_server->stop();
             tcp_server.reset();
+            ocm::SessionRecorder::get_instance().stop();
             ocm::log(ocm::LogLevel::INFO, "Server stopped.");
         }
         ocm::log(ocm::LogLevel::INFO, "OBS Camera Move unloaded successfully!");
         obs_module_loaded.store(false);
+        ocm::Logger::get_instance().shutdown();
     } catch (const std::exception &e) {
         ocm::log(ocm::LogLevel::ERROR, std::string("Exception occurred while unloading OBS Camera move: ") + e.what());
+        ocm::Logger::get_instance().shutdown();
     }
 }
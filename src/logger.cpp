@@ -7,12 +7,22 @@
 #include <filesystem>
 
 namespace ObsCamMove {
-    Logger::Logger() {
+    LogLevel to_log_level(const String& name, const LogLevel default_level) {
+        if (name == "debug") return LogLevel::DEBUG;
+        if (name == "info") return LogLevel::INFO;
+        if (name == "warn") return LogLevel::WARN;
+        if (name == "error") return LogLevel::ERROR;
+        return default_level;
+    }
+
+    Logger::Logger() : queue_(QUEUE_CAPACITY) {
 
     }
 
     void Logger::set_log_file(const String& log_path) {
+        std::lock_guard lock(mutex_);
         log_file_path_ = log_path;
+        log_file_.close();
 
         // Create directory if not exist
         try {
@@ -25,51 +35,158 @@ namespace ObsCamMove {
         }
     }
 
-    void Logger::log(const LogLevel level, const std::string& message) {
+    void Logger::set_min_level(const LogLevel level) {
+        min_level_.store(level, std::memory_order_relaxed);
+    }
+
+    String Logger::get_log_file_path() {
         std::lock_guard lock(mutex_);
+        return log_file_path_;
+    }
+
+    void Logger::log(const LogLevel level, std::string message) {
+        if (!is_enabled(level)) {
+            return;
+        }
 
+        LogEntry entry{ level, std::chrono::system_clock::now(), std::move(message) };
+
+        if (stopped_.load(std::memory_order_acquire)) {
+            std::lock_guard lock(mutex_);
+            write_entry(entry);
+            return;
+        }
+
+        std::call_once(worker_started_, [this] { start_worker(); });
+        if (!queue_.try_push(std::move(entry))) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        pending_.fetch_add(1, std::memory_order_release);
+        pending_.notify_one();
+    }
+
+    void Logger::shutdown() {
+        {
+            std::lock_guard lock(worker_mutex_);
+            if (stopped_.exchange(true)) {
+                return;
+            }
+        }
+
+        worker_running_.store(false);
+        pending_.fetch_add(1, std::memory_order_release);
+        pending_.notify_one();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+
+        // Messages that were queued while the worker was stopping
+        write_pending();
+    }
+
+    void Logger::start_worker() {
+        std::lock_guard lock(worker_mutex_);
+        if (stopped_.load()) {
+            return;
+        }
+        worker_running_.store(true);
+        worker_ = std::thread([this] { run_worker(); });
+    }
+
+    void Logger::run_worker() {
+        while (true) {
+            const u32 seen = pending_.load(std::memory_order_acquire);
+            if (write_pending() > 0) {
+                continue;
+            }
+            if (!worker_running_.load()) {
+                break;
+            }
+            pending_.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    usize Logger::write_pending() {
+        std::lock_guard lock(mutex_);
+
+        usize count = 0;
+        LogEntry entry;
+        while (queue_.try_pop(entry)) {
+            write_entry(entry);
+            count++;
+        }
+
+        if (const auto dropped = dropped_.exchange(0, std::memory_order_relaxed); dropped > 0) {
+            write_entry({ LogLevel::WARN, std::chrono::system_clock::now(),
+                          std::format("Log queue full; {} message(s) dropped", dropped) });
+            count++;
+        }
+
+        // One flush per batch instead of one per line
+        if (count > 0 && log_file_.is_open()) {
+            log_file_.flush();
+        }
+        return count;
+    }
+
+    void Logger::write_entry(const LogEntry& entry) {
         // Write to OBS protocol
-        switch (level) {
+        switch (entry.level) {
             case LogLevel::DEBUG:
-                blog(LOG_DEBUG, "%s", message.c_str());
+                blog(LOG_DEBUG, "%s", entry.message.c_str());
                 break;
             case LogLevel::INFO:
-                blog(LOG_INFO, "%s", message.c_str());
+                blog(LOG_INFO, "%s", entry.message.c_str());
                 break;
             case LogLevel::WARN:
-                blog(LOG_WARNING, "%s", message.c_str());
+                blog(LOG_WARNING, "%s", entry.message.c_str());
                 break;
             case LogLevel::ERROR:
-                blog(LOG_ERROR, "%s", message.c_str());
+                blog(LOG_ERROR, "%s", entry.message.c_str());
                 break;
             default:
                 break;;
         }
 
-        write_to_logfile(level, message);
+        write_to_logfile(entry);
     }
 
-    void Logger::write_to_logfile(const LogLevel level, const std::string& message) {
+    void Logger::write_to_logfile(const LogEntry& entry) {
         if (!ensure_log_path_exists()) {
             return;
         }
 
-        std::ofstream log_file(log_file_path_, std::ios::out | std::ios::app);
-        if (!log_file.is_open()) {
-            return;
+        // The file stays open; it is reopened only when the log path changes
+        if (!log_file_.is_open()) {
+            log_file_.open(log_file_path_, std::ios::out | std::ios::app);
+            if (!log_file_.is_open()) {
+                return;
+            }
         }
 
-        const auto now = std::chrono::system_clock::now();
-        const auto time_now = std::chrono::system_clock::to_time_t(now);
-        const auto tm_now = *std::localtime(&time_now);
+        log_file_ << "[" << get_log_level_string(entry.level) << "] "
+                  << format_timestamp(entry.time) << " | "
+                  << entry.message
+                  << '\n';
 
-        std::ostringstream timestamp;
-        timestamp << std::put_time(&tm_now, "%Y-%m-%d %H:%M:%S");
+        if (stopped_.load(std::memory_order_relaxed)) {
+            log_file_.flush();
+        }
+    }
+
+    const String& Logger::format_timestamp(const std::chrono::system_clock::time_point time) {
+        // The timestamp has a resolution of one second, so consecutive lines mostly share it
+        if (const auto time_now = std::chrono::system_clock::to_time_t(time); time_now != last_timestamp_time_) {
+            const auto tm_now = *std::localtime(&time_now);
 
-        log_file << "[" << get_log_level_string(level) << "] "
-                 << timestamp.str() << " | "
-                 << message
-                 << std::endl;
+            std::ostringstream timestamp;
+            timestamp << std::put_time(&tm_now, "%Y-%m-%d %H:%M:%S");
+            last_timestamp_ = timestamp.str();
+            last_timestamp_time_ = time_now;
+        }
+        return last_timestamp_;
     }
 
     String Logger::get_log_level_string(const LogLevel level) {
@@ -109,9 +226,15 @@ namespace ObsCamMove {
         }
 
         try {
-            set_log_file(get_default_log_file_path());
+            log_file_path_ = get_default_log_file_path();
+            if (!log_file_path_.empty()) {
+                if (const std::filesystem::path log_dir = std::filesystem::path(log_file_path_).parent_path(); !exists(log_dir)) {
+                    create_directory(log_dir);
+                }
+            }
             return !log_file_path_.empty();
         } catch (std::exception&) {
+            log_file_path_ = "";
             return false;
         }
     }
@@ -1,9 +1,19 @@
 #pragma once
 
 #include "prerequisites.h"
+#include "bounded_queue.h"
+#include <atomic>
+#include <chrono>
+#include <format>
 #include <fstream>
 #include <mutex>
 #include <string>
+#include <thread>
+
+// Set to 0 to compile out all log_debug() calls, including the formatting of their arguments
+#ifndef OBS_CAMERA_MOVE_ENABLE_DEBUG_LOG
+    #define OBS_CAMERA_MOVE_ENABLE_DEBUG_LOG 1
+#endif
 
 namespace ObsCamMove {
     enum class LogLevel {
@@ -13,6 +23,10 @@ namespace ObsCamMove {
         ERROR
     };
 
+    [[nodiscard]] LogLevel to_log_level(const String& name, LogLevel default_level = LogLevel::INFO);
+
+    //! Messages are handed to a background thread through a lock-free queue; the thread writes
+    //! them to the OBS log and the log file in batches. After shutdown() logging is synchronous.
     class Logger {
     public:
         static Logger& get_instance() {
@@ -21,19 +35,55 @@ namespace ObsCamMove {
         }
 
         void set_log_file(const String& log_path);
-        void log(LogLevel level, const std::string& message);
+        void set_min_level(LogLevel level);
+        [[nodiscard]] bool is_enabled(const LogLevel level) const {
+            return level >= min_level_.load(std::memory_order_relaxed);
+        }
+
+        void log(LogLevel level, std::string message);
         String get_log_file_path();
 
+        //! Writes all pending messages and stops the background thread. Safe to call more than once.
+        void shutdown();
+
     private:
+        struct LogEntry {
+            LogLevel level = LogLevel::INFO;
+            std::chrono::system_clock::time_point time;
+            std::string message;
+        };
+
+        static constexpr usize QUEUE_CAPACITY = 4096;
+
         String log_file_path_;
-        std::string logFilePath_;
+        std::ofstream log_file_;
         std::mutex mutex_;
+        std::atomic<LogLevel> min_level_ = LogLevel::INFO;
+
+        BoundedQueue<LogEntry> queue_;
+        std::mutex worker_mutex_; // Orders starting the worker against shutdown(), so none starts after it
+        std::thread worker_;
+        std::once_flag worker_started_;
+        std::atomic_bool worker_running_ = false;
+        std::atomic_bool stopped_ = false;
+        std::atomic<u32> pending_ = 0;
+        std::atomic<u64> dropped_ = 0;
+
+        std::time_t last_timestamp_time_ = 0;
+        String last_timestamp_;
 
         Logger();
+        // A static with a joinable thread would terminate the process when the module is unloaded
+        ~Logger() { shutdown(); }
         Logger(Logger const&) = delete;
         Logger& operator=(Logger const&) = delete;
 
-        void write_to_logfile(LogLevel level, const std::string& message);
+        void start_worker();
+        void run_worker();
+        usize write_pending();
+        void write_entry(const LogEntry& entry);
+        void write_to_logfile(const LogEntry& entry);
+        const String& format_timestamp(std::chrono::system_clock::time_point time);
 
         [[nodiscard]] static String get_log_level_string(LogLevel level);
         [[nodiscard]] static String get_default_log_file_path();
@@ -41,7 +91,23 @@ namespace ObsCamMove {
         bool ensure_log_path_exists();
     };
 
-    inline void log(const LogLevel level, const std::string& message) {
-        Logger::get_instance().log(level, message);
+    inline void log(const LogLevel level, std::string message) {
+        Logger::get_instance().log(level, std::move(message));
+    }
+
+    //! Formats the message only if the level is enabled.
+    template<typename... Args>
+    void log(const LogLevel level, std::format_string<Args...> format, Args&&... args) {
+        if (auto& logger = Logger::get_instance(); logger.is_enabled(level)) {
+            logger.log(level, std::format(format, std::forward<Args>(args)...));
+        }
+    }
+
+    //! DEBUG message that is removed at compile time if OBS_CAMERA_MOVE_ENABLE_DEBUG_LOG is 0.
+    template<typename... Args>
+    void log_debug([[maybe_unused]] std::format_string<Args...> format, [[maybe_unused]] Args&&... args) {
+        if constexpr (OBS_CAMERA_MOVE_ENABLE_DEBUG_LOG != 0) {
+            log(LogLevel::DEBUG, format, std::forward<Args>(args)...);
+        }
     }
 }
@@ -1,40 +1,130 @@
 #include "message_command.h"
-#include "logger.h"
 #include "string_utils.h"
-#include <sstream>
+#include <algorithm>
 
 namespace ObsCamMove {
-    static const std::regex COMMAND_REGEX(R"(^(\w+)\(([^)]*)\);?$)");
-
-    MessageCommand::MessageCommand(const String& message) : raw_msg_(message) {
-        log(LogLevel::DEBUG, "Parsing message command: " + message);
-        if (std::smatch match; std::regex_match(raw_msg_, match, COMMAND_REGEX)) {
-            command_ = match[1];
-            const String params = match[2];
-
-            // Extract command parameters
-            std::istringstream param_stream(params);
-            String param;
-            while (std::getline(param_stream, param, ',')) {
-                params_.push_back(trim(param));
+    static bool is_word_char(const char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    MessageCommand::MessageCommand(const StringView message) : raw_msg_(message) {
+        valid_ = parse();
+        if (!valid_) {
+            command_ = {};
+            param_count_ = 0;
+        }
+    }
+
+    MessageCommand::MessageCommand(const StringView command, const std::span<const float> values)
+        : command_(command), valid_(true), typed_(true) {
+        param_count_ = std::min(values.size(), INLINE_PARAMS);
+        std::copy_n(values.begin(), param_count_, values_.begin());
+        inline_params_.fill({});
+    }
+
+    // Hand-written equivalent of the former regex ^(\w+)\(([^)]*)\);?$ with the parameters split
+    // at ',' like std::getline does (no trailing empty parameter) and trimmed.
+    bool MessageCommand::parse() {
+        const StringView msg = raw_msg_;
+
+        usize name_end = 0;
+        while (name_end < msg.size() && is_word_char(msg[name_end])) {
+            name_end++;
+        }
+        if (name_end == 0 || name_end == msg.size() || msg[name_end] != '(') {
+            return false;
+        }
+
+        const usize params_end = msg.find(')', name_end + 1);
+        if (params_end == StringView::npos) {
+            return false;
+        }
+
+        if (const StringView rest = msg.substr(params_end + 1); !rest.empty() && rest != ";") {
+            return false;
+        }
+
+        command_ = msg.substr(0, name_end);
+
+        StringView params = msg.substr(name_end + 1, params_end - name_end - 1);
+        while (!params.empty()) {
+            const usize comma = params.find(',');
+            add_param(trim_view(params.substr(0, comma)));
+            if (comma == StringView::npos) {
+                break;
             }
+            params.remove_prefix(comma + 1);
+        }
+
+        return true;
+    }
 
-            log(LogLevel::DEBUG, "Command parse: " + command_);
-            log(LogLevel::DEBUG, "Parameters parsed: " + std::to_string(params_.size()));
+    void MessageCommand::add_param(const StringView param) {
+        if (param_count_ < INLINE_PARAMS) {
+            inline_params_[param_count_] = param;
         } else {
-            log(LogLevel::ERROR, "Invalid message command: " + raw_msg_);
+            if (param_count_ == INLINE_PARAMS) {
+                overflow_params_.assign(inline_params_.begin(), inline_params_.end());
+            }
+            overflow_params_.push_back(param);
         }
+        param_count_++;
+    }
+
+    bool MessageCommand::is_valid() const {
+        return valid_;
     }
 
-    const String& MessageCommand::get_message() const {
+    StringView MessageCommand::get_message() const {
         return raw_msg_;
     }
 
-    const String& MessageCommand::get_command() const {
+    StringView MessageCommand::get_command() const {
         return command_;
     }
 
-    const std::vector<String>& MessageCommand::get_params() const {
-        return params_;
+    usize MessageCommand::param_count() const {
+        return param_count_;
+    }
+
+    std::errc MessageCommand::get_int(const usize index, int& value) const {
+        if (index >= param_count_) {
+            return std::errc::invalid_argument;
+        }
+        if (typed_) {
+            value = static_cast<int>(values_[index]);
+            return {};
+        }
+        return parse_int(get_params()[index], value);
+    }
+
+    std::errc MessageCommand::get_float(const usize index, float& value) const {
+        if (typed_ && index < param_count_) {
+            value = values_[index];
+            return {};
+        }
+
+        int int_value = 0;
+        const auto ec = get_int(index, int_value);
+        value = static_cast<float>(int_value);
+        return ec;
+    }
+
+    std::errc MessageCommand::get_decimal(const usize index, float& value) const {
+        if (index >= param_count_) {
+            return std::errc::invalid_argument;
+        }
+        if (typed_) {
+            value = values_[index];
+            return {};
+        }
+        return parse_float(get_params()[index], value);
+    }
+
+    std::span<const StringView> MessageCommand::get_params() const {
+        if (param_count_ > INLINE_PARAMS) {
+            return overflow_params_;
+        }
+        return { inline_params_.data(), param_count_ };
     }
 }
@@ -1,20 +1,48 @@
 #pragma once
 
 #include "prerequisites.h"
-#include <regex>
+#include <array>
+#include <span>
+#include <system_error>
+#include <vector>
 
 namespace ObsCamMove {
+    //! Parses a text command of the form `name(param, param, ...);`.
+    //! The command and parameters are views into the message, which must outlive the command.
     class MessageCommand {
     public:
-        explicit MessageCommand(const String& message);
+        explicit MessageCommand(StringView message);
+        //! Creates a command from already typed numeric parameters, e.g. decoded from a binary frame.
+        MessageCommand(StringView command, std::span<const float> values);
 
-        [[nodiscard]] const String& get_message() const;
-        [[nodiscard]] const String& get_command() const;
-        [[nodiscard]] const std::vector<String>& get_params() const;
+        [[nodiscard]] bool is_valid() const;
+        [[nodiscard]] StringView get_message() const;
+        [[nodiscard]] StringView get_command() const;
+        //! Text of the parameters; empty views for commands created from typed values.
+        [[nodiscard]] std::span<const StringView> get_params() const;
+        [[nodiscard]] usize param_count() const;
+
+        //! Reads a parameter as integer; text is parsed with the leniency of std::stoi.
+        [[nodiscard]] std::errc get_int(usize index, int& value) const;
+        //! Reads a parameter as float; text parameters must be integers.
+        [[nodiscard]] std::errc get_float(usize index, float& value) const;
+        //! Reads a parameter as float; text parameters may have a fractional part (e.g. a scale of 1.5).
+        [[nodiscard]] std::errc get_decimal(usize index, float& value) const;
 
     private:
-        const String raw_msg_;
-        String command_;
-        std::vector<String> params_;
+        // Commands with up to this many parameters are parsed without any heap allocation
+        static constexpr usize INLINE_PARAMS = 16;
+
+        StringView raw_msg_;
+        StringView command_;
+        std::array<StringView, INLINE_PARAMS> inline_params_;
+        std::vector<StringView> overflow_params_;
+        std::array<float, INLINE_PARAMS> values_;
+        usize param_count_ = 0;
+        bool valid_ = false;
+        bool typed_ = false;
+
+        bool parse();
+        void add_param(StringView param);
     };
 }
@@ -0,0 +1,180 @@
+#include "message_framer.h"
+#include "binary_protocol.h"
+#include "string_utils.h"
+#include <cstring>
+
+namespace ObsCamMove {
+    FramingMode to_framing_mode(const String& name) {
+        if (name == "newline") {
+            return FramingMode::Newline;
+        }
+        if (name == "length") {
+            return FramingMode::LengthPrefixed;
+        }
+        return FramingMode::Auto;
+    }
+
+    ReceiveBuffer::ReceiveBuffer(const usize initial_capacity) : storage_(initial_capacity) {
+    }
+
+    std::span<char> ReceiveBuffer::prepare(const usize min_size) {
+        if (storage_.size() - write_pos_ < min_size) {
+            // Move the unread bytes to the front before growing the storage
+            const usize unread = size();
+            if (read_pos_ > 0) {
+                std::memmove(storage_.data(), storage_.data() + read_pos_, unread);
+                read_pos_ = 0;
+                write_pos_ = unread;
+            }
+            if (storage_.size() - write_pos_ < min_size) {
+                storage_.resize(std::max(storage_.size() * 2, write_pos_ + min_size));
+            }
+        }
+        return { storage_.data() + write_pos_, storage_.size() - write_pos_ };
+    }
+
+    void ReceiveBuffer::commit(const usize size) {
+        write_pos_ = std::min(write_pos_ + size, storage_.size());
+    }
+
+    void ReceiveBuffer::consume(const usize size) {
+        read_pos_ = std::min(read_pos_ + size, write_pos_);
+        if (read_pos_ == write_pos_) {
+            read_pos_ = 0;
+            write_pos_ = 0;
+        }
+    }
+
+    StringView ReceiveBuffer::data() const {
+        return { storage_.data() + read_pos_, size() };
+    }
+
+    MessageFramer::MessageFramer(const FramingMode mode)
+        : mode_(mode), protocol_detected_(mode != FramingMode::Auto) {
+        // In an explicit mode the first byte is data, e.g. the low byte of a length prefix
+    }
+
+    std::span<char> MessageFramer::prepare(const usize min_size) {
+        return buffer_.prepare(min_size);
+    }
+
+    void MessageFramer::commit(const usize size) {
+        buffer_.commit(size);
+    }
+
+    std::optional<StringView> MessageFramer::next_message() {
+        if (buffer_.size() == 0 || overflowed_) {
+            return std::nullopt;
+        }
+
+        if (!protocol_detected_) {
+            protocol_detected_ = true;
+            if (static_cast<u8>(buffer_.data().front()) == BINARY_PROTOCOL_MAGIC) {
+                mode_ = FramingMode::Binary;
+                buffer_.consume(1);
+                return next_binary_frame();
+            }
+        }
+
+        switch (mode_) {
+            case FramingMode::Auto: {
+                if (buffer_.data().find('\n') != StringView::npos) {
+                    // The client terminates its messages, so it may also pipeline them
+                    mode_ = FramingMode::Newline;
+                    return next_line();
+                }
+
+                // Legacy clients send one message per write without a delimiter
+                const StringView message = trim_view(buffer_.data());
+                buffer_.consume(buffer_.size());
+                return message;
+            }
+            case FramingMode::Newline:
+                return next_line();
+            case FramingMode::LengthPrefixed:
+                return next_length_prefixed();
+            case FramingMode::Binary:
+                return next_binary_frame();
+        }
+        return std::nullopt;
+    }
+
+    std::optional<StringView> MessageFramer::next_line() {
+        while (true) {
+            const StringView data = buffer_.data();
+            const usize end = data.find('\n', scan_pos_);
+            if (end == StringView::npos) {
+                // Only scan the new bytes next time
+                scan_pos_ = data.size();
+                overflowed_ = data.size() > MAX_MESSAGE_SIZE;
+                return std::nullopt;
+            }
+
+            // consume() keeps the bytes in place until the next prepare(), so the view stays valid
+            const StringView line = trim_view(data.substr(0, end));
+            buffer_.consume(end + 1);
+            scan_pos_ = 0;
+
+            if (!line.empty()) {
+                return line;
+            }
+        }
+    }
+
+    std::optional<StringView> MessageFramer::next_length_prefixed() {
+        const StringView data = buffer_.data();
+        if (data.size() < sizeof(u32)) {
+            return std::nullopt;
+        }
+
+        const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+        const u32 length = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<u32>(bytes[3]) << 24);
+        if (length > MAX_MESSAGE_SIZE) {
+            overflowed_ = true;
+            return std::nullopt;
+        }
+        if (data.size() < sizeof(u32) + length) {
+            return std::nullopt;
+        }
+
+        const StringView message = data.substr(sizeof(u32), length);
+        buffer_.consume(sizeof(u32) + length);
+        return message;
+    }
+
+    std::optional<StringView> MessageFramer::next_binary_frame() {
+        const StringView data = buffer_.data();
+        if (data.size() < BinaryFrame::SIZE) {
+            return std::nullopt;
+        }
+
+        buffer_.consume(BinaryFrame::SIZE);
+        return data.substr(0, BinaryFrame::SIZE);
+    }
+
+    void MessageFramer::append_reply(String& out, const StringView reply) const {
+        append_reply(out, reply, mode_);
+    }
+
+    void MessageFramer::append_reply(String& out, const StringView reply, const FramingMode mode) {
+        switch (mode) {
+            case FramingMode::Newline:
+                out.append(reply);
+                out.push_back('\n');
+                break;
+            case FramingMode::LengthPrefixed: {
+                const auto length = static_cast<u32>(reply.size());
+                const char header[] = {
+                    static_cast<char>(length & 0xFF), static_cast<char>((length >> 8) & 0xFF),
+                    static_cast<char>((length >> 16) & 0xFF), static_cast<char>((length >> 24) & 0xFF)
+                };
+                out.append(header, sizeof(header));
+                out.append(reply);
+                break;
+            }
+            default:
+                out.append(reply);
+                break;
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "prerequisites.h"
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace ObsCamMove {
+    enum class FramingMode : u8 {
+        //! One read is one message until the first '\n' is received, then Newline (default)
+        Auto,
+        //! Messages and replies are terminated by '\n' ("\r\n" is accepted as well)
+        Newline,
+        //! Messages and replies are preceded by their length as 32-bit little-endian integer
+        LengthPrefixed,
+        //! Fixed-size binary frames, selected in Auto mode by the client with BINARY_PROTOCOL_MAGIC as first byte
+        Binary,
+    };
+
+    [[nodiscard]] FramingMode to_framing_mode(const String& name);
+
+    //! Receive buffer that grows on demand and compacts unread data to the front, so that every
+    //! message stays contiguous and can be handed out as a view.
+    class ReceiveBuffer {
+    public:
+        explicit ReceiveBuffer(usize initial_capacity = 1024);
+
+        //! Returns writable space of at least min_size bytes behind the unread data.
+        [[nodiscard]] std::span<char> prepare(usize min_size);
+        void commit(usize size);
+        void consume(usize size);
+
+        [[nodiscard]] StringView data() const;
+        [[nodiscard]] usize size() const { return write_pos_ - read_pos_; }
+
+    private:
+        std::vector<char> storage_;
+        usize read_pos_ = 0;
+        usize write_pos_ = 0;
+    };
+
+    //! Splits the byte stream of a connection into messages and frames the replies.
+    class MessageFramer {
+    public:
+        static constexpr usize MAX_MESSAGE_SIZE = 64 * 1024;
+
+        explicit MessageFramer(FramingMode mode = FramingMode::Auto);
+
+        [[nodiscard]] std::span<char> prepare(usize min_size = 1024);
+        void commit(usize size);
+
+        //! Returns the next complete message; the view is valid until the next prepare().
+        [[nodiscard]] std::optional<StringView> next_message();
+        //! True if a message exceeded MAX_MESSAGE_SIZE; the connection should be closed.
+        [[nodiscard]] bool overflowed() const { return overflowed_; }
+        [[nodiscard]] FramingMode get_mode() const { return mode_; }
+
+        //! Appends the reply to out with the delimiter or length prefix of the current mode.
+        void append_reply(String& out, StringView reply) const;
+        //! Appends the reply to out with the delimiter or length prefix of the given mode.
+        static void append_reply(String& out, StringView reply, FramingMode mode);
+
+    private:
+        FramingMode mode_;
+        ReceiveBuffer buffer_;
+        usize scan_pos_ = 0;
+        bool overflowed_ = false;
+        bool protocol_detected_; // The magic byte is only looked for in Auto mode
+
+        std::optional<StringView> next_line();
+        std::optional<StringView> next_length_prefixed();
+        std::optional<StringView> next_binary_frame();
+    };
+}
@@ -1,41 +1,274 @@
 #include "message_handler.h"
 #include "message_command.h"
+#include "command_table.h"
 #include "logger.h"
 #include "string_utils.h"
-#include <regex>
 
 #include "camera_controller.h"
+#include "camera_easing.h"
+#include "animation_scheduler.h"
+#include "motion_constraints.h"
+#include <algorithm>
+#include <array>
 
 namespace ObsCamMove {
-    MessageHandler::MessageHandler() {
-        register_handler("test_echo", handle_test_echo);
-        register_handler("set_camera_names", handle_set_camera_names);
-        register_handler("get_camera_name", handle_get_camera_name);
-        register_handler("move_to", handle_move_to);
-        register_handler("move_by", handle_move_by);
-        register_handler("get_camera_position", handle_get_camera_position);
+    MessageHandler::MessageHandler() : batch_metrics_(Metrics::get_instance().register_command("batch")) {
     }
 
-    void MessageHandler::register_handler(const std::string& command, HandlerFunction handler) {
-        handlers_[command] = std::move(handler);
+    MessageHandler::ResolvedCommand MessageHandler::find_command(const StringView name) {
+        static constexpr Command COMMANDS[] = {
+            { "test_echo", without_context<handle_test_echo> },
+            { "set_camera_names", without_context<handle_set_camera_names> },
+            { "get_camera_name", without_context<handle_get_camera_name> },
+            { "move_to", without_context<handle_move_to>, true },
+            { "move_by", without_context<handle_move_by>, true },
+            { "move_path", without_context<handle_move_path>, true },
+            { "get_camera_position", without_context<handle_get_camera_position> },
+            { "set_velocity", without_context<handle_set_velocity> },
+            { "set_target", without_context<handle_set_target> },
+            { "set_motion_limits", without_context<handle_set_motion_limits> },
+            { "set_interrupt_moves", without_context<handle_set_interrupt_moves> },
+            { "get_stats", without_context<handle_get_stats> },
+            { "subscribe_position", handle_subscribe_position },
+            { "set_position", without_context<handle_set_position>, true },
+            { "scale_to", without_context<handle_scale_to>, true },
+            { "zoom", without_context<handle_zoom>, true },
+            { "rotate", without_context<handle_rotate>, true },
+            { "crop_to", without_context<handle_crop_to>, true },
+            { "fade_in", without_context<handle_fade_in>, true },
+            { "fade_out", without_context<handle_fade_out>, true },
+            { "animate", without_context<handle_animate>, true },
+            { "get_scale", without_context<handle_get_scale> },
+            { "follow", without_context<handle_follow> },
+            { "stop_follow", without_context<handle_stop_follow> },
+            { "set_bounds", without_context<handle_set_bounds> },
+            { "lock_position", without_context<handle_lock_position> },
+            { "set_keep_out", without_context<handle_set_keep_out> },
+            { "clear_constraints", without_context<handle_clear_constraints> },
+            { "get_camera_state", without_context<handle_get_camera_state> },
+        };
+        static constexpr usize COMMAND_COUNT = std::size(COMMANDS);
+
+        static constexpr StaticCommandTable<COMMAND_COUNT> TABLE([] {
+            std::array<StringView, COMMAND_COUNT> names;
+            std::ranges::transform(COMMANDS, names.begin(), &Command::name);
+            return names;
+        }());
+
+        // The metrics are registered once per process, in table order
+        static const auto METRICS = [] {
+            std::array<CommandMetrics*, COMMAND_COUNT> metrics;
+            for (usize i = 0; i < COMMAND_COUNT; i++) {
+                metrics[i] = Metrics::get_instance().register_command(COMMANDS[i].name);
+            }
+            return metrics;
+        }();
+
+        const usize index = TABLE.find(name);
+        if (index == COMMAND_COUNT) {
+            return {};
+        }
+        return { &COMMANDS[index], METRICS[index] };
+    }
+
+    std::optional<std::string> MessageHandler::process_message(const StringView message,
+                                                               const MessageContext& context) const {
+        if (StringView commands = trim_view(message); commands.starts_with("batch(")) {
+            if (commands.ends_with(';')) {
+                commands.remove_suffix(1);
+            }
+            if (commands.ends_with(')')) {
+                commands = commands.substr(6, commands.size() - 7);
+                const u64 start_ns = steady_clock_ns();
+                auto response = process_batch(commands, context);
+                batch_metrics_->latency.record(steady_clock_ns() - start_ns);
+                batch_metrics_->count.fetch_add(1, std::memory_order_relaxed);
+                if (response.starts_with("ERROR")) {
+                    batch_metrics_->errors.fetch_add(1, std::memory_order_relaxed);
+                }
+                return response;
+            }
+        }
+
+        return process_command(message, context);
     }
 
-    std::optional<std::string> MessageHandler::process_message(const std::string& message) {
+    String MessageHandler::process_batch(StringView commands, const MessageContext& context) const {
+        // Commands are separated by ';' outside of quoted parameters
+        std::array<StringView, MAX_BATCH_COMMANDS> batch_commands;
+        usize command_count = 0;
+        bool quoted = false;
+        usize start = 0;
+        for (usize i = 0; i <= commands.size(); i++) {
+            if (i < commands.size() && commands[i] == '"') {
+                quoted = !quoted;
+            }
+            if (i < commands.size() && (quoted || commands[i] != ';')) {
+                continue;
+            }
+
+            if (const auto command = trim_view(commands.substr(start, i - start)); !command.empty()) {
+                if (command_count == MAX_BATCH_COMMANDS) {
+                    return log_error(std::format("A batch has at most {} commands", MAX_BATCH_COMMANDS));
+                }
+                if (command.starts_with("batch(")) {
+                    return log_error("Batches can not be nested");
+                }
+                batch_commands[command_count++] = command;
+            }
+            start = i + 1;
+        }
+
+        if (command_count == 0) {
+            return log_error("Empty batch");
+        }
+
+        // Anything but a staged animation would take effect before the batch could still fail
+        for (usize i = 0; i < command_count; i++) {
+            const auto name = trim_view(batch_commands[i].substr(0, batch_commands[i].find('(')));
+            if (const auto [command, metrics] = find_command(name); command != nullptr && !command->batchable) {
+                return log_error(std::format("Batch discarded, command {} can not be batched: {}", i + 1, name));
+            }
+        }
+
+        // Moves are collected by the batch and only start on commit, all with the same frame
+        AnimationBatch batch;
+        String replies;
+        for (usize i = 0; i < command_count; i++) {
+            const auto reply = process_command(batch_commands[i], context);
+            if (!reply.has_value() || reply->starts_with("ERROR")) {
+                return log_error(std::format("Batch discarded, command {} failed: {}", i + 1,
+                                             reply.value_or("No response")));
+            }
+            if (batch.failed()) {
+                return log_error(std::format("Batch discarded, command {} failed: {}", i + 1, batch.error()));
+            }
+            if (i > 0) {
+                replies += "; ";
+            }
+            replies += *reply;
+        }
+        if (!batch.commit()) {
+            return log_error(std::format("Batch discarded: {}", batch.error()));
+        }
+        return replies;
+    }
+
+    std::optional<std::string> MessageHandler::process_command(const StringView message,
+                                                               const MessageContext& context) const {
         try {
+            log_debug("Parsing message command: {}", message);
             const MessageCommand message_command(message);
-
-            if (const auto it = handlers_.find(message_command.get_command()); it != handlers_.end()) {
-                return it->second(message_command);
+            if (!message_command.is_valid()) {
+                log(LogLevel::ERROR, "Invalid message command: " + String(message));
+            } else {
+                log_debug("Command parse: {}", message_command.get_command());
+                log_debug("Parameters parsed: {}", message_command.param_count());
             }
 
-            log(LogLevel::ERROR, String("Unknown command: ") + message_command.get_command());
-            return std::nullopt;
+            return dispatch(message_command, context);
         } catch (const std::exception& e) {
             log(LogLevel::ERROR, String("Error processing message: ") + e.what());
             return std::nullopt;
         }
     }
 
+    void MessageHandler::process_binary_message(const StringView frame, String& out,
+                                                const MessageContext& context) const {
+        const auto opcode = frame.empty() ? u8{0} : static_cast<u8>(frame[0]);
+        const auto decoded = decode_binary_frame(frame);
+        const auto command_name = decoded ? get_binary_command_name(decoded->opcode) : StringView();
+        if (command_name.empty()) {
+            log(LogLevel::ERROR, "Unknown binary opcode: {}", opcode);
+            append_binary_reply(out, opcode, BinaryStatus::Error, "ERROR: Unknown opcode");
+            return;
+        }
+
+        switch (decoded->opcode) {
+            case BinaryOpcode::GetCameraPosition:
+            case BinaryOpcode::GetCameraScale:
+            case BinaryOpcode::GetCameraState:
+                process_binary_query(decoded->opcode, command_name, out);
+                return;
+            default:
+                break;
+        }
+
+        // Other binary frames are mapped onto the same handlers as the text commands
+        const float values[] = { decoded->x, decoded->y, static_cast<float>(decoded->duration_ms),
+                                 static_cast<float>(decoded->easing) };
+        usize value_count = 0;
+        switch (decoded->opcode) {
+            case BinaryOpcode::MoveTo:
+            case BinaryOpcode::MoveBy:
+                value_count = std::size(values);
+                break;
+            case BinaryOpcode::SetVelocity:
+            case BinaryOpcode::SetTarget:
+                value_count = 2;
+                break;
+            case BinaryOpcode::SubscribePosition:
+                value_count = 1;
+                break;
+            default:
+                break;
+        }
+
+        std::optional<String> response;
+        try {
+            response = dispatch(MessageCommand(command_name, std::span(values, value_count)), context);
+        } catch (const std::exception& e) {
+            log(LogLevel::ERROR, String("Error processing message: ") + e.what());
+        }
+
+        if (!response.has_value()) {
+            append_binary_reply(out, opcode, BinaryStatus::Error, "ERROR: No response");
+        } else if (response->starts_with("ERROR")) {
+            append_binary_reply(out, opcode, BinaryStatus::Error, *response);
+        } else {
+            append_binary_reply(out, opcode, BinaryStatus::Ok, *response == "OK" ? StringView() : StringView(*response));
+        }
+    }
+
+    void MessageHandler::process_binary_query(const BinaryOpcode opcode, const StringView command_name, String& out) {
+        auto& metrics = *find_command(command_name).metrics;
+        const u64 start_ns = steady_clock_ns();
+
+        // Queries reply with the values themselves, not with the text of the text commands
+        String error;
+        if (const auto state = CameraController::getInstance().get_state(error); !state) {
+            append_binary_reply(out, static_cast<u8>(opcode), BinaryStatus::Error, error);
+            metrics.errors.fetch_add(1, std::memory_order_relaxed);
+        } else if (opcode == BinaryOpcode::GetCameraState) {
+            append_binary_state_reply(out, state->position, state->scale, state->progress, state->moving);
+        } else {
+            append_binary_reply(out, static_cast<u8>(opcode),
+                                opcode == BinaryOpcode::GetCameraScale ? state->scale : state->position);
+        }
+
+        metrics.latency.record(steady_clock_ns() - start_ns);
+        metrics.count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::optional<std::string> MessageHandler::dispatch(const MessageCommand& message_command,
+                                                        const MessageContext& context) const {
+        if (const auto [command, command_metrics] = find_command(message_command.get_command()); command != nullptr) {
+            auto& metrics = *command_metrics;
+            const u64 start_ns = steady_clock_ns();
+            auto response = command->handler(message_command, context);
+            metrics.latency.record(steady_clock_ns() - start_ns);
+            metrics.count.fetch_add(1, std::memory_order_relaxed);
+            if (response.starts_with("ERROR")) {
+                metrics.errors.fetch_add(1, std::memory_order_relaxed);
+            }
+            return response;
+        }
+
+        Metrics::get_instance().unknown_commands.fetch_add(1, std::memory_order_relaxed);
+        log(LogLevel::ERROR, String("Unknown command: ") + String(message_command.get_command()));
+        return std::nullopt;
+    }
+
     String MessageHandler::log_error(const String& message) {
         log(LogLevel::ERROR, message);
         return String("ERROR: ") + message;
@@ -48,15 +281,15 @@ namespace ObsCamMove {
             return "Test echo: This test message is 100% gluten-free, enjoy responsibly!";
         }
 
-        return String("Test echo: ") + params[0];
+        return String("Test echo: ") + String(params[0]);
     }
 
     String MessageHandler::handle_set_camera_names(const MessageCommand& command) {
         if (const auto& params = command.get_params(); params.size() > 0) {
             std::vector<String> camera_names;
 
-            for (auto str : command.get_params()) {
-                if (const auto camera_name = remove_quotes(str, true); !camera_name.empty()) {
+            for (const auto str : command.get_params()) {
+                if (const auto camera_name = remove_quotes(String(str), true); !camera_name.empty()) {
                     camera_names.push_back(camera_name);
                 }
             }
@@ -74,59 +307,522 @@ namespace ObsCamMove {
         return CameraController::getInstance().get_camera_name();
     }
 
+    bool MessageHandler::parse_move_params(const MessageCommand& command, float& x, float& y, int& duration, u8& easing,
+                                           String& item_name, String& error) {
+        const auto param_count = command.param_count();
+        const auto command_name = String(command.get_command());
+
+        if (param_count < 3 || param_count > 5) {
+            error = log_error("Wrong number of parameters for " + command_name + " command: ") + std::to_string(param_count);
+            return false;
+        }
+
+        int easing_value = 0;
+        std::errc ec = command.get_float(0, x);
+        if (ec == std::errc{}) ec = command.get_float(1, y);
+        if (ec == std::errc{}) ec = command.get_int(2, duration);
+        if (ec == std::errc{} && param_count > 3) ec = command.get_int(3, easing_value);
+
+        if (ec == std::errc::invalid_argument) {
+            error = log_error("Invalid parameter(s) for " + command_name + ". All parameters must be integers.");
+            return false;
+        }
+        if (ec == std::errc::result_out_of_range) {
+            error = log_error("Parameter(s) out of range for " + command_name + ".");
+            return false;
+        }
+
+        easing = static_cast<u8>(easing_value);
+        if (easing > static_cast<u8>(CameraEasingType::EaseInOutElastic)) {
+            error = log_error("Invalid easing type for " + command_name + ": ") + std::to_string(easing);
+            return false;
+        }
+
+        item_name = param_count > 4 ? remove_quotes(String(command.get_params()[4]), true) : String();
+        return true;
+    }
+
     String MessageHandler::handle_move_to(const MessageCommand& command) {
-        const auto& params = command.get_params();
+        float x, y;
+        int duration;
+        u8 easing;
+        String item_name, error;
+        if (!parse_move_params(command, x, y, duration, easing, item_name, error)) {
+            return error;
+        }
+
+        CameraController::getInstance().move_to(x, y, duration, easing, item_name);
+        return "OK";
+    }
 
-         if (params.size() < 3 || params.size() > 4) {
-            return log_error("Wrong number of parameters for move_to command: ") + std::to_string(params.size());
+    String MessageHandler::handle_move_by(const MessageCommand& command) {
+        float dx, dy;
+        int duration;
+        u8 easing;
+        String item_name, error;
+        if (!parse_move_params(command, dx, dy, duration, easing, item_name, error)) {
+            return error;
         }
 
-        try {
-            const int x = std::stoi(String(params[0]));
-            const int y = std::stoi(String(params[1]));
-            const int duration = std::stoi(String(params[2]));
+        CameraController::getInstance().move_by(dx, dy, duration, easing, item_name);
+        return "OK";
+    }
 
-            u8 easing = 0;
-            if (params.size() > 3) {
-                easing = std::stoi(String(params[3]));
+    String MessageHandler::handle_move_path(const MessageCommand& command) {
+        constexpr usize max_waypoints = 64;
+
+        // move_path(x1, y1, x2, y2, ..., duration, easing)
+        const auto param_count = command.param_count();
+        if (param_count < 4 || param_count % 2 != 0 || (param_count - 2) / 2 > max_waypoints) {
+            return log_error("Wrong number of parameters for move_path command: ") + std::to_string(param_count);
+        }
+
+        std::vector<vec2> waypoints((param_count - 2) / 2);
+        int duration = 0;
+        int easing_value = 0;
+        std::errc ec{};
+        for (usize i = 0; i < waypoints.size() && ec == std::errc{}; i++) {
+            ec = command.get_float(2 * i, waypoints[i].x);
+            if (ec == std::errc{}) ec = command.get_float(2 * i + 1, waypoints[i].y);
+        }
+        if (ec == std::errc{}) ec = command.get_int(param_count - 2, duration);
+        if (ec == std::errc{}) ec = command.get_int(param_count - 1, easing_value);
+
+        if (ec != std::errc{}) {
+            return log_error("Invalid parameter(s) for move_path. All parameters must be integers.");
+        }
+        if (easing_value < 0 || easing_value > static_cast<int>(CameraEasingType::EaseInOutElastic)) {
+            return log_error("Invalid easing type for move_path: ") + std::to_string(easing_value);
+        }
+
+        CameraController::getInstance().move_path(waypoints, duration, static_cast<u8>(easing_value));
+        return "OK";
+    }
+
+    String MessageHandler::handle_get_camera_position(const MessageCommand&) {
+        return CameraController::getInstance().get_position();
+    }
+
+    bool MessageHandler::parse_timing_params(const MessageCommand& command, const usize first, int& duration,
+                                             u8& easing, String& item_name, String& error) {
+        const auto param_count = command.param_count();
+        const auto command_name = command.get_command();
+
+        int easing_value = 0;
+        std::errc ec = command.get_int(first, duration);
+        if (ec == std::errc{} && param_count > first + 1) ec = command.get_int(first + 1, easing_value);
+        if (ec != std::errc{}) {
+            error = log_error(std::format("Invalid duration or easing for {}.", command_name));
+            return false;
+        }
+        if (easing_value < 0 || easing_value > static_cast<int>(CameraEasingType::EaseInOutElastic)) {
+            error = log_error(std::format("Invalid easing type for {}: {}", command_name, easing_value));
+            return false;
+        }
+
+        easing = static_cast<u8>(easing_value);
+        item_name = param_count > first + 2 ? remove_quotes(String(command.get_params()[first + 2]), true) : String();
+        return true;
+    }
+
+    bool MessageHandler::parse_transform_params(const MessageCommand& command, const std::span<float> values,
+                                                int& duration, u8& easing, String& item_name, String& error) {
+        const auto param_count = command.param_count();
+        if (param_count < values.size() + 1 || param_count > values.size() + 3) {
+            error = log_error(std::format("Wrong number of parameters for {} command: {}", command.get_command(),
+                                          param_count));
+            return false;
+        }
+
+        for (usize i = 0; i < values.size(); i++) {
+            if (command.get_decimal(i, values[i]) != std::errc{}) {
+                error = log_error(std::format("Invalid parameter(s) for {}. Values must be numbers.",
+                                              command.get_command()));
+                return false;
             }
+        }
+        return parse_timing_params(command, values.size(), duration, easing, item_name, error);
+    }
 
-            CameraController::getInstance().move_to(x, y, duration, easing);
-            return "OK";
-        } catch (const std::invalid_argument& e) {
-            return log_error("Invalid parameter(s) for move_to. All parameters must be integers.");
-        } catch (const std::out_of_range& e) {
-            return log_error("Parameter(s) out of range for move_to.");
+    String MessageHandler::handle_set_position(const MessageCommand& command) {
+        const auto param_count = command.param_count();
+        float x, y;
+        if (param_count < 2 || param_count > 3 || command.get_decimal(0, x) != std::errc{}
+            || command.get_decimal(1, y) != std::errc{}) {
+            return log_error("set_position expects x, y and optionally the name of a scene item");
         }
+
+        const auto item_name = param_count > 2 ? remove_quotes(String(command.get_params()[2]), true) : String();
+        CameraController::getInstance().set_position(x, y, item_name);
+        return "OK";
     }
 
-    String MessageHandler::handle_move_by(const MessageCommand& command) {
-        const auto& params = command.get_params();
+    String MessageHandler::handle_scale_to(const MessageCommand& command) {
+        float scale[2];
+        int duration;
+        u8 easing;
+        String item_name, error;
+        if (!parse_transform_params(command, scale, duration, easing, item_name, error)) {
+            return error;
+        }
 
-        if (params.size() < 3 || params.size() > 4) {
-            return log_error("Wrong number of parameters for move_to command: ") + std::to_string(params.size());
+        CameraController::getInstance().scale_to(scale[0], scale[1], duration, easing, item_name);
+        return "OK";
+    }
+
+    String MessageHandler::handle_zoom(const MessageCommand& command) {
+        float factor[1];
+        int duration;
+        u8 easing;
+        String item_name, error;
+        if (!parse_transform_params(command, factor, duration, easing, item_name, error)) {
+            return error;
+        }
+        if (!(factor[0] > 0.0f)) {
+            return log_error("The zoom factor must be positive.");
         }
 
-        try {
-            const int dx = std::stoi(String(params[0]));
-            const int dy = std::stoi(String(params[1]));
-            const int duration = std::stoi(String(params[2]));
+        CameraController::getInstance().zoom(factor[0], duration, easing, item_name);
+        return "OK";
+    }
 
-            u8 easing = 0;
-            if (params.size() > 3) {
-                easing = std::stoi(String(params[3]));
+    String MessageHandler::handle_rotate(const MessageCommand& command) {
+        float angle[1];
+        int duration;
+        u8 easing;
+        String item_name, error;
+        if (!parse_transform_params(command, angle, duration, easing, item_name, error)) {
+            return error;
+        }
+
+        CameraController::getInstance().rotate(angle[0], duration, easing, item_name);
+        return "OK";
+    }
+
+    String MessageHandler::handle_crop_to(const MessageCommand& command) {
+        float crop[4];
+        int duration;
+        u8 easing;
+        String item_name, error;
+        if (!parse_transform_params(command, crop, duration, easing, item_name, error)) {
+            return error;
+        }
+
+        CameraController::getInstance().crop_to(crop[0], crop[1], crop[2], crop[3], duration, easing, item_name);
+        return "OK";
+    }
+
+    String MessageHandler::handle_fade_in(const MessageCommand& command) {
+        int duration;
+        u8 easing;
+        String item_name, error;
+        if (!parse_transform_params(command, {}, duration, easing, item_name, error)) {
+            return error;
+        }
+
+        CameraController::getInstance().fade_in(duration, easing, item_name);
+        return "OK";
+    }
+
+    String MessageHandler::handle_fade_out(const MessageCommand& command) {
+        int duration;
+        u8 easing;
+        String item_name, error;
+        if (!parse_transform_params(command, {}, duration, easing, item_name, error)) {
+            return error;
+        }
+
+        CameraController::getInstance().fade_out(duration, easing, item_name);
+        return "OK";
+    }
+
+    String MessageHandler::handle_animate(const MessageCommand& command) {
+        // animate(duration, easing, channel=value, ..., item="name"); "scale" sets both scale channels
+        const auto params = command.get_params();
+        if (params.size() < 3) {
+            return log_error("animate expects a duration, an easing and at least one channel=value");
+        }
+
+        int duration, easing_value;
+        if (command.get_int(0, duration) != std::errc{} || command.get_int(1, easing_value) != std::errc{}) {
+            return log_error("Invalid duration or easing for animate.");
+        }
+        if (easing_value < 0 || easing_value > static_cast<int>(CameraEasingType::EaseInOutElastic)) {
+            return log_error("Invalid easing type for animate: ") + std::to_string(easing_value);
+        }
+
+        TransformValues target;
+        String item_name;
+        for (usize i = 2; i < params.size(); i++) {
+            const auto separator = params[i].find('=');
+            if (separator == StringView::npos) {
+                return log_error(std::format("Expected channel=value in animate: {}", params[i]));
+            }
+
+            const auto name = trim_view(params[i].substr(0, separator));
+            const auto text = params[i].substr(separator + 1);
+            if (name == "item") {
+                item_name = remove_quotes(String(text), true);
+                continue;
             }
 
-            CameraController::getInstance().move_by(dx, dy, duration);
-            return "OK";
-        } catch (const std::invalid_argument& e) {
-            return log_error("Invalid parameter(s) for move_to. All parameters must be integers.");
-        } catch (const std::out_of_range& e) {
-            return log_error("Parameter(s) out of range for move_to.");
+            float value;
+            if (parse_float(text, value) != std::errc{}) {
+                return log_error(std::format("Invalid value for {} in animate: {}", name, text));
+            }
+            if (name == "scale") {
+                target.set(TransformChannel::ScaleX, value);
+                target.set(TransformChannel::ScaleY, value);
+            } else if (const auto channel = to_transform_channel(name)) {
+                target.set(*channel, value);
+            } else {
+                return log_error(std::format("Unknown channel in animate: {}", name));
+            }
         }
+
+        if (target.mask == 0) {
+            return log_error("animate expects at least one channel=value");
+        }
+
+        CameraController::getInstance().animate(target, duration, static_cast<u8>(easing_value), item_name);
+        return "OK";
     }
 
-    String MessageHandler::handle_get_camera_position(const MessageCommand&) {
-        return CameraController::getInstance().get_position();
+    String MessageHandler::handle_get_scale(const MessageCommand&) {
+        return CameraController::getInstance().get_scale();
+    }
+
+    String MessageHandler::handle_get_camera_state(const MessageCommand&) {
+        return CameraController::getInstance().get_camera_state();
+    }
+
+    bool MessageHandler::parse_vector_params(const MessageCommand& command, float& x, float& y, String& error) {
+        const auto command_name = command.get_command();
+        if (command.param_count() != 2) {
+            error = log_error(std::format("Wrong number of parameters for {} command: {}", command_name,
+                                          command.param_count()));
+            return false;
+        }
+
+        std::errc ec = command.get_float(0, x);
+        if (ec == std::errc{}) ec = command.get_float(1, y);
+        if (ec != std::errc{}) {
+            error = log_error(std::format("Invalid parameter(s) for {}. All parameters must be integers.", command_name));
+            return false;
+        }
+        return true;
+    }
+
+    // The streaming commands run at up to a few hundred Hz: they only store the value and reply "OK"
+    String MessageHandler::handle_set_velocity(const MessageCommand& command) {
+        float vx, vy;
+        String error;
+        if (!parse_vector_params(command, vx, vy, error)) {
+            return error;
+        }
+
+        CameraController::getInstance().set_velocity(vx, vy);
+        return "OK";
+    }
+
+    String MessageHandler::handle_set_target(const MessageCommand& command) {
+        float x, y;
+        String error;
+        if (!parse_vector_params(command, x, y, error)) {
+            return error;
+        }
+
+        CameraController::getInstance().set_target(x, y);
+        return "OK";
+    }
+
+    String MessageHandler::handle_set_motion_limits(const MessageCommand& command) {
+        float max_speed, max_acceleration;
+        String error;
+        if (!parse_vector_params(command, max_speed, max_acceleration, error)) {
+            return error;
+        }
+        if (max_speed <= 0.0f || max_acceleration <= 0.0f) {
+            return log_error("Motion limits must be positive.");
+        }
+
+        CameraController::getInstance().set_motion_limits(max_speed, max_acceleration);
+        return "OK";
+    }
+
+    String MessageHandler::handle_set_interrupt_moves(const MessageCommand& command) {
+        int enabled = 0;
+        if (command.param_count() != 1 || command.get_int(0, enabled) != std::errc{} || (enabled != 0 && enabled != 1)) {
+            return log_error("set_interrupt_moves expects 1 (enabled) or 0 (disabled)");
+        }
+
+        CameraController::getInstance().set_interrupt_moves(enabled == 1);
+        return "OK";
+    }
+
+    String MessageHandler::handle_follow(const MessageCommand& command) {
+        // follow("item"[, offset_x, offset_y[, dead_zone[, stiffness]]])
+        constexpr float default_stiffness = 8.0f;
+
+        const auto param_count = command.param_count();
+        if (param_count < 1 || param_count == 2 || param_count > 5) {
+            return log_error("follow expects the name of a scene item, optionally followed by the offset, "
+                             "the dead zone and the stiffness");
+        }
+
+        const auto target_name = remove_quotes(String(command.get_params()[0]), true);
+        if (target_name.empty()) {
+            return log_error("follow expects the name of a scene item");
+        }
+
+        vec2 offset = {};
+        float dead_zone = 0.0f;
+        float stiffness = default_stiffness;
+        std::errc ec{};
+        if (param_count > 1) ec = command.get_decimal(1, offset.x);
+        if (ec == std::errc{} && param_count > 2) ec = command.get_decimal(2, offset.y);
+        if (ec == std::errc{} && param_count > 3) ec = command.get_decimal(3, dead_zone);
+        if (ec == std::errc{} && param_count > 4) ec = command.get_decimal(4, stiffness);
+        if (ec != std::errc{}) {
+            return log_error("Invalid parameter(s) for follow. Offset, dead zone and stiffness must be numbers.");
+        }
+        if (!(dead_zone >= 0.0f) || !(stiffness > 0.0f)) {
+            return log_error("The dead zone of follow must not be negative and its stiffness must be positive.");
+        }
+
+        CameraController::getInstance().follow(target_name, offset, dead_zone, stiffness);
+        return "OK";
+    }
+
+    String MessageHandler::handle_stop_follow(const MessageCommand&) {
+        CameraController::getInstance().stop_follow();
+        return "OK";
+    }
+
+    bool MessageHandler::resolve_constrained_item(String& item_name, String& error) {
+        if (!item_name.empty()) {
+            return true;
+        }
+
+        // Rules are kept by source name, so the webcam's rules stay with the source it is now
+        item_name = CameraController::getInstance().get_camera_name();
+        if (item_name.starts_with("ERROR")) {
+            error = item_name;
+            return false;
+        }
+        return true;
+    }
+
+    String MessageHandler::handle_set_bounds(const MessageCommand& command) {
+        // set_bounds(min_x, min_y, max_x, max_y[, "item"])
+        const auto param_count = command.param_count();
+        Rect bounds;
+        std::errc ec = param_count == 4 || param_count == 5 ? std::errc{} : std::errc::invalid_argument;
+        if (ec == std::errc{}) ec = command.get_decimal(0, bounds.left);
+        if (ec == std::errc{}) ec = command.get_decimal(1, bounds.top);
+        if (ec == std::errc{}) ec = command.get_decimal(2, bounds.right);
+        if (ec == std::errc{}) ec = command.get_decimal(3, bounds.bottom);
+        if (ec != std::errc{} || !(bounds.right > bounds.left) || !(bounds.bottom > bounds.top)) {
+            return log_error("set_bounds expects min_x, min_y, max_x, max_y (max > min) and optionally a scene item");
+        }
+
+        auto item_name = param_count > 4 ? remove_quotes(String(command.get_params()[4]), true) : String();
+        if (String error; !resolve_constrained_item(item_name, error)) {
+            return error;
+        }
+
+        MotionConstraints::get_instance().set_bounds(item_name, bounds);
+        return "OK";
+    }
+
+    String MessageHandler::handle_lock_position(const MessageCommand& command) {
+        // lock_position(1|0[, "item"])
+        const auto param_count = command.param_count();
+        int locked = 0;
+        if (param_count < 1 || param_count > 2 || command.get_int(0, locked) != std::errc{}
+            || (locked != 0 && locked != 1)) {
+            return log_error("lock_position expects 1 (locked) or 0 (unlocked) and optionally a scene item");
+        }
+
+        auto item_name = param_count > 1 ? remove_quotes(String(command.get_params()[1]), true) : String();
+        if (String error; !resolve_constrained_item(item_name, error)) {
+            return error;
+        }
+
+        MotionConstraints::get_instance().set_locked(item_name, locked == 1);
+        return "OK";
+    }
+
+    String MessageHandler::handle_set_keep_out(const MessageCommand& command) {
+        // set_keep_out("item", "other", ...); an empty item is the webcam, no others remove the keep-out
+        const auto params = command.get_params();
+        if (params.empty()) {
+            return log_error("set_keep_out expects the scene item (\"\" for the webcam) and the items to keep out of");
+        }
+
+        auto item_name = remove_quotes(String(params[0]), true);
+        if (String error; !resolve_constrained_item(item_name, error)) {
+            return error;
+        }
+
+        std::vector<String> keep_out_names;
+        for (usize i = 1; i < params.size(); i++) {
+            if (auto name = remove_quotes(String(params[i]), true); !name.empty()) {
+                keep_out_names.push_back(std::move(name));
+            }
+        }
+
+        MotionConstraints::get_instance().set_keep_out(item_name, keep_out_names);
+        return "OK";
+    }
+
+    String MessageHandler::handle_clear_constraints(const MessageCommand& command) {
+        // clear_constraints(["item"])
+        if (command.param_count() > 1) {
+            return log_error("clear_constraints expects no parameter or a scene item");
+        }
+
+        auto item_name = command.param_count() == 1 ? remove_quotes(String(command.get_params()[0]), true) : String();
+        if (String error; !resolve_constrained_item(item_name, error)) {
+            return error;
+        }
+
+        MotionConstraints::get_instance().clear(item_name);
+        return "OK";
+    }
+
+    String MessageHandler::handle_get_stats(const MessageCommand& command) {
+        int reset = 0;
+        if (command.param_count() > 1 || (command.param_count() == 1 && command.get_int(0, reset) != std::errc{})
+            || (reset != 0 && reset != 1)) {
+            return log_error("get_stats expects no parameter or 1 to reset the statistics after reading");
+        }
+
+        auto& metrics = Metrics::get_instance();
+        auto stats = metrics.to_json();
+        if (reset == 1) {
+            metrics.reset();
+        }
+        return stats;
+    }
+
+    String MessageHandler::handle_subscribe_position(const MessageCommand& command, const MessageContext& context) {
+        float rate_hz = 0.0f;
+        if (command.param_count() != 1 || command.get_float(0, rate_hz) != std::errc{} || !(rate_hz >= 0.0f)) {
+            return log_error("subscribe_position expects the updates per second (1 up to the frame rate; others are clamped), or 0 to unsubscribe");
+        }
+
+        const auto subscriber = context.subscriber.lock();
+        if (!subscriber) {
+            return log_error("subscribe_position is only available on a connection");
+        }
+
+        auto& publisher = PositionPublisher::get_instance();
+        if (rate_hz == 0.0f) {
+            publisher.unsubscribe(subscriber.get());
+        } else {
+            publisher.subscribe(subscriber, rate_hz);
+        }
+        return "OK";
     }
 }
@@ -2,31 +2,101 @@
 
 #include "prerequisites.h"
 #include "message_command.h"
+#include "binary_protocol.h"
+#include "metrics.h"
+#include "position_publisher.h"
 #include <string>
-#include <unordered_map>
-#include <functional>
 #include <optional>
 
 namespace ObsCamMove {
+    //! The client a message came from, for commands that keep state per client.
+    struct MessageContext {
+        std::weak_ptr<PositionSubscriber> subscriber;
+    };
+
     class MessageHandler {
     public:
-        using HandlerFunction = std::function<String(const MessageCommand&)>;
+        using HandlerFunction = String (*)(const MessageCommand&, const MessageContext&);
+
+        //! Commands per batch(...) message at most.
+        static constexpr usize MAX_BATCH_COMMANDS = 64;
 
         MessageHandler();
 
-        std::optional<std::string> process_message(const std::string& message);
+        //! Thread-safe: the command table is built at compile time and shared by all handlers. A message
+        //! `batch(command; command; ...)` runs the commands as a unit: the moves they start begin with the
+        //! same frame, or none of them if a command fails. Only commands that start animations can be
+        //! batched, so a failed batch has no effect at all. The reply lists the replies separated by "; ".
+        std::optional<std::string> process_message(StringView message, const MessageContext& context = {}) const;
+        //! Processes one binary protocol frame and appends the binary reply to out.
+        void process_binary_message(StringView frame, String& out, const MessageContext& context = {}) const;
 
     private:
-        std::unordered_map<std::string, HandlerFunction> handlers_;
+        struct Command {
+            StringView name;
+            HandlerFunction handler;
+            bool batchable = false; // Only stages an animation, so it can be part of a batch
+        };
+
+        struct ResolvedCommand {
+            const Command* command = nullptr;
+            CommandMetrics* metrics = nullptr;
+        };
+
+        CommandMetrics* batch_metrics_;
+
+        //! Looks the command up in the table of all commands; command is nullptr for unknown commands.
+        static ResolvedCommand find_command(StringView name);
+        template<String (*Handler)(const MessageCommand&)>
+        static String without_context(const MessageCommand& command, const MessageContext&) {
+            return Handler(command);
+        }
 
-        void register_handler(const std::string& command, HandlerFunction handler);
+        std::optional<std::string> process_command(StringView message, const MessageContext& context) const;
+        String process_batch(StringView commands, const MessageContext& context) const;
+        static void process_binary_query(BinaryOpcode opcode, StringView command_name, String& out);
+        std::optional<std::string> dispatch(const MessageCommand& message_command, const MessageContext& context) const;
 
         static String log_error(const String& message);
+        static bool parse_move_params(const MessageCommand& command, float& x, float& y, int& duration, u8& easing,
+                                      String& item_name, String& error);
         static String handle_test_echo(const MessageCommand& command);
         static String handle_set_camera_names(const MessageCommand& command);
         static String handle_get_camera_name(const MessageCommand& command);
         static String handle_move_to(const MessageCommand& command);
         static String handle_move_by(const MessageCommand& command);
+        static String handle_move_path(const MessageCommand& command);
         static String handle_get_camera_position(const MessageCommand& command);
+        //! Parses the trailing `duration[, easing[, "item"]]` parameters starting at index first.
+        static bool parse_timing_params(const MessageCommand& command, usize first, int& duration, u8& easing,
+                                        String& item_name, String& error);
+        //! Parses values.size() numbers followed by the timing parameters.
+        static bool parse_transform_params(const MessageCommand& command, std::span<float> values, int& duration,
+                                           u8& easing, String& item_name, String& error);
+        static String handle_set_position(const MessageCommand& command);
+        static String handle_scale_to(const MessageCommand& command);
+        static String handle_zoom(const MessageCommand& command);
+        static String handle_rotate(const MessageCommand& command);
+        static String handle_crop_to(const MessageCommand& command);
+        static String handle_fade_in(const MessageCommand& command);
+        static String handle_fade_out(const MessageCommand& command);
+        static String handle_animate(const MessageCommand& command);
+        static String handle_get_scale(const MessageCommand& command);
+        static String handle_get_camera_state(const MessageCommand& command);
+        static bool parse_vector_params(const MessageCommand& command, float& x, float& y, String& error);
+        static String handle_set_velocity(const MessageCommand& command);
+        static String handle_set_target(const MessageCommand& command);
+        static String handle_set_motion_limits(const MessageCommand& command);
+        static String handle_set_interrupt_moves(const MessageCommand& command);
+        static String handle_follow(const MessageCommand& command);
+        //! Source name the constraint commands refer to: the given item, or the webcam if it is empty.
+        static bool resolve_constrained_item(String& item_name, String& error);
+        static String handle_set_bounds(const MessageCommand& command);
+        static String handle_lock_position(const MessageCommand& command);
+        static String handle_set_keep_out(const MessageCommand& command);
+        static String handle_clear_constraints(const MessageCommand& command);
+        static String handle_stop_follow(const MessageCommand& command);
+        static String handle_get_stats(const MessageCommand& command);
+        static String handle_subscribe_position(const MessageCommand& command, const MessageContext& context);
     };
 }
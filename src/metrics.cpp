@@ -0,0 +1,146 @@
+#include "metrics.h"
+#include <bit>
+#include <format>
+
+namespace ObsCamMove {
+    usize LatencyHistogram::bucket_index(const u64 value) {
+        // Values below SUB_BUCKETS get a bucket each; above, each power of two is split into SUB_BUCKETS
+        if (value < SUB_BUCKETS) {
+            return static_cast<usize>(value);
+        }
+        const u32 msb = 63 - static_cast<u32>(std::countl_zero(value));
+        const u64 sub = (value >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + static_cast<usize>(sub);
+    }
+
+    u64 LatencyHistogram::bucket_upper_bound(const usize index) {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        const u32 msb = static_cast<u32>(index / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+        const u64 sub = index % SUB_BUCKETS;
+        const u64 lower = (SUB_BUCKETS + sub) << (msb - SUB_BUCKET_BITS);
+        return lower + (u64{1} << (msb - SUB_BUCKET_BITS)) - 1;
+    }
+
+    void LatencyHistogram::record(const u64 value_ns) {
+        buckets_[bucket_index(value_ns)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+
+        u64 max = max_.load(std::memory_order_relaxed);
+        while (value_ns > max && !max_.compare_exchange_weak(max, value_ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    u64 LatencyHistogram::percentile(const double fraction, const u64 count) const {
+        const auto rank = static_cast<u64>(fraction * static_cast<double>(count - 1)) + 1;
+        u64 seen = 0;
+        for (usize i = 0; i < BUCKET_COUNT; i++) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                return std::min(bucket_upper_bound(i), max_.load(std::memory_order_relaxed));
+            }
+        }
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    LatencyHistogram::Summary LatencyHistogram::summarize() const {
+        Summary summary;
+        summary.count = count_.load(std::memory_order_relaxed);
+        summary.max = max_.load(std::memory_order_relaxed);
+        if (summary.count > 0) {
+            summary.p50 = percentile(0.50, summary.count);
+            summary.p95 = percentile(0.95, summary.count);
+            summary.p99 = percentile(0.99, summary.count);
+        }
+        return summary;
+    }
+
+    void LatencyHistogram::reset() {
+        // Values recorded concurrently with a reset may be half counted; acceptable for monitoring
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    void CommandMetrics::reset() {
+        count.store(0, std::memory_order_relaxed);
+        errors.store(0, std::memory_order_relaxed);
+        latency.reset();
+    }
+
+    CommandMetrics* Metrics::register_command(const StringView name) {
+        std::lock_guard lock(mutex_);
+        for (auto& [command, metrics] : commands_) {
+            if (command == name) {
+                return &metrics;
+            }
+        }
+        // A deque never moves its elements, so the returned pointers stay valid
+        return &commands_.emplace_back(std::piecewise_construct, std::forward_as_tuple(name), std::forward_as_tuple()).second;
+    }
+
+    static void append_histogram(String& out, const StringView name, const LatencyHistogram& histogram) {
+        const auto summary = histogram.summarize();
+        std::format_to(std::back_inserter(out), R"("{}":{{"count":{},"p50":{},"p95":{},"p99":{},"max":{}}})",
+                       name, summary.count, summary.p50, summary.p95, summary.p99, summary.max);
+    }
+
+    String Metrics::to_json() const {
+        String out = "{\"commands\":{";
+        {
+            std::lock_guard lock(mutex_);
+            bool first = true;
+            for (const auto& [command, metrics] : commands_) {
+                std::format_to(std::back_inserter(out), R"({}"{}":{{"count":{},"errors":{},)", first ? "" : ",",
+                               command, metrics.count.load(std::memory_order_relaxed),
+                               metrics.errors.load(std::memory_order_relaxed));
+                append_histogram(out, "latency_ns", metrics.latency);
+                out += '}';
+                first = false;
+            }
+        }
+
+        std::format_to(std::back_inserter(out), R"(}},"connection":{{"messages":{},"unknown_commands":{},)",
+                       messages.load(std::memory_order_relaxed), unknown_commands.load(std::memory_order_relaxed));
+        append_histogram(out, "receive_to_reply_ns", receive_to_reply);
+
+        std::format_to(std::back_inserter(out),
+                       R"(}},"animation":{{"moves_started":{},"frames_applied":{},"moves_finished":{},)",
+                       moves_started.load(std::memory_order_relaxed), frames_applied.load(std::memory_order_relaxed),
+                       moves_finished.load(std::memory_order_relaxed));
+        append_histogram(out, "move_start_latency_ns", move_start_latency);
+        out += ',';
+        append_histogram(out, "frame_lateness_ns", frame_lateness);
+        out += ',';
+        append_histogram(out, "frame_interval_ns", frame_interval);
+        out += ',';
+        append_histogram(out, "frame_jitter_ns", frame_jitter);
+        out += ',';
+        append_histogram(out, "move_overshoot_ns", move_overshoot);
+        out += "}}";
+        return out;
+    }
+
+    void Metrics::reset() {
+        {
+            std::lock_guard lock(mutex_);
+            for (auto& [command, metrics] : commands_) {
+                metrics.reset();
+            }
+        }
+        messages.store(0, std::memory_order_relaxed);
+        unknown_commands.store(0, std::memory_order_relaxed);
+        receive_to_reply.reset();
+        moves_started.store(0, std::memory_order_relaxed);
+        frames_applied.store(0, std::memory_order_relaxed);
+        moves_finished.store(0, std::memory_order_relaxed);
+        move_start_latency.reset();
+        frame_lateness.reset();
+        frame_interval.reset();
+        frame_jitter.reset();
+        move_overshoot.reset();
+    }
+}
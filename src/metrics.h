@@ -0,0 +1,97 @@
+#pragma once
+
+#include "prerequisites.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ObsCamMove {
+    //! Lock-free latency histogram with fixed logarithmic buckets (8 per power of two, so a
+    //! percentile is accurate to within 12.5%).
+    class LatencyHistogram {
+    public:
+        struct Summary {
+            u64 count = 0;
+            u64 p50 = 0;
+            u64 p95 = 0;
+            u64 p99 = 0;
+            u64 max = 0;
+        };
+
+        void record(u64 value_ns);
+        [[nodiscard]] Summary summarize() const;
+        void reset();
+
+    private:
+        static constexpr u32 SUB_BUCKET_BITS = 3;
+        static constexpr u32 SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+        static constexpr usize BUCKET_COUNT = 64 * SUB_BUCKETS;
+
+        std::array<std::atomic<u64>, BUCKET_COUNT> buckets_{};
+        std::atomic<u64> count_ = 0;
+        std::atomic<u64> max_ = 0;
+
+        [[nodiscard]] static usize bucket_index(u64 value);
+        [[nodiscard]] static u64 bucket_upper_bound(usize index);
+        [[nodiscard]] u64 percentile(double fraction, u64 count) const;
+    };
+
+    struct CommandMetrics {
+        std::atomic<u64> count = 0;
+        std::atomic<u64> errors = 0;
+        LatencyHistogram latency; // Handler run time, from parsed command to reply
+
+        void reset();
+    };
+
+    //! Counters and latency histograms of the control path, readable with the get_stats command.
+    class Metrics {
+    public:
+        static Metrics& get_instance() {
+            static Metrics instance;
+            return instance;
+        }
+
+        //! Returns the metrics of a command; the pointer stays valid for the lifetime of the program.
+        CommandMetrics* register_command(StringView name);
+
+        // Connection: from the read that completed a message to its reply being queued
+        std::atomic<u64> messages = 0;
+        std::atomic<u64> unknown_commands = 0;
+        LatencyHistogram receive_to_reply;
+
+        // Animations: from scheduling a move to the first frame applying it, and per applied frame
+        // the delay behind the frame's timestamp, the interval to the previous frame and how much that
+        // interval differs from the previous one (jitter). A move ends with the first frame at or after
+        // its deadline (start frame + duration); the overshoot is how far that frame lies past it.
+        std::atomic<u64> moves_started = 0;
+        std::atomic<u64> frames_applied = 0;
+        std::atomic<u64> moves_finished = 0;
+        LatencyHistogram move_start_latency;
+        LatencyHistogram frame_lateness;
+        LatencyHistogram frame_interval;
+        LatencyHistogram frame_jitter;
+        LatencyHistogram move_overshoot;
+
+        //! All metrics as single-line JSON, so the reply fits every framing mode.
+        [[nodiscard]] String to_json() const;
+        void reset();
+
+    private:
+        mutable std::mutex mutex_; // Only guards the command registry
+        std::deque<std::pair<String, CommandMetrics>> commands_;
+
+        Metrics() = default;
+        Metrics(Metrics const&) = delete;
+        Metrics& operator=(Metrics const&) = delete;
+    };
+
+    inline u64 steady_clock_ns() {
+        return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
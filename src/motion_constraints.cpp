@@ -0,0 +1,311 @@
+#include "motion_constraints.h"
+#include "logger.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ObsCamMove {
+    void RectGrid::build(const std::span<const Rect> rects) {
+        rects_.assign(rects.begin(), rects.end());
+        visited_.assign(rects_.size(), 0);
+        stamp_ = 0;
+        if (rects_.empty()) {
+            cols_ = rows_ = 0;
+            cell_start_.clear();
+            entries_.clear();
+            return;
+        }
+
+        float right = rects_.front().right;
+        float bottom = rects_.front().bottom;
+        origin_x_ = rects_.front().left;
+        origin_y_ = rects_.front().top;
+        for (const auto& rect : rects_) {
+            origin_x_ = std::min(origin_x_, rect.left);
+            origin_y_ = std::min(origin_y_, rect.top);
+            right = std::max(right, rect.right);
+            bottom = std::max(bottom, rect.bottom);
+        }
+        // Far apart rectangles (or one at +-1e6) would need millions of cells; coarser cells keep the grid
+        // small, and a single cell (a linear scan) is left if the extent is not even finite
+        const double width = static_cast<double>(right) - origin_x_;
+        const double height = static_cast<double>(bottom) - origin_y_;
+        cell_size_ = CELL_SIZE;
+        const auto cell_count = [&](const double size) { return (std::floor(width / size) + 1) * (std::floor(height / size) + 1); };
+        while (std::isfinite(width) && std::isfinite(height) && cell_count(cell_size_) > MAX_CELLS) {
+            cell_size_ *= 2.0f;
+        }
+        if (std::isfinite(cell_size_) && cell_count(cell_size_) <= MAX_CELLS) {
+            cols_ = static_cast<u32>(width / cell_size_) + 1;
+            rows_ = static_cast<u32>(height / cell_size_) + 1;
+        } else {
+            cols_ = rows_ = 1;
+        }
+
+        // Counting sort of the (cell, rectangle) pairs into one flat array
+        cell_start_.assign(cols_ * rows_ + 1, 0);
+        const auto for_each_cell = [&](const Rect& rect, auto&& callback) {
+            const auto [first_col, last_col] = cell_range(rect.left, rect.right, origin_x_, cols_);
+            const auto [first_row, last_row] = cell_range(rect.top, rect.bottom, origin_y_, rows_);
+            for (u32 row = first_row; row <= last_row && first_col <= last_col; row++) {
+                for (u32 col = first_col; col <= last_col; col++) {
+                    callback(row * cols_ + col);
+                }
+            }
+        };
+        for (const auto& rect : rects_) {
+            for_each_cell(rect, [&](const u32 cell) { cell_start_[cell + 1]++; });
+        }
+        for (usize cell = 0; cell + 1 < cell_start_.size(); cell++) {
+            cell_start_[cell + 1] += cell_start_[cell];
+        }
+        entries_.resize(cell_start_.back());
+        std::vector<u32> fill(cell_start_.begin(), cell_start_.end() - 1);
+        for (u32 index = 0; index < rects_.size(); index++) {
+            for_each_cell(rects_[index], [&](const u32 cell) { entries_[fill[cell]++] = index; });
+        }
+    }
+
+    std::pair<u32, u32> RectGrid::cell_range(const float low, const float high, const float origin, const u32 count) const {
+        if (count == 1) {
+            return high > low ? std::pair<u32, u32>{ 0, 0 } : std::pair<u32, u32>{ 1, 0 };
+        }
+        const float first = std::floor((low - origin) / cell_size_);
+        const float last = std::floor((high - origin) / cell_size_);
+        if (last < 0.0f || first >= static_cast<float>(count) || high <= low) {
+            return { 1, 0 };
+        }
+        return { static_cast<u32>(std::max(first, 0.0f)),
+                 static_cast<u32>(std::min(last, static_cast<float>(count - 1))) };
+    }
+
+    vec2 get_item_size(const obs_sceneitem_t* item) {
+        obs_transform_info info;
+        obs_sceneitem_get_info2(item, &info);
+        if (info.bounds_type != OBS_BOUNDS_NONE) {
+            return info.bounds;
+        }
+
+        const obs_source_t* source = obs_sceneitem_get_source(item);
+        return { static_cast<float>(obs_source_get_width(const_cast<obs_source_t*>(source))) * std::abs(info.scale.x),
+                 static_cast<float>(obs_source_get_height(const_cast<obs_source_t*>(source))) * std::abs(info.scale.y) };
+    }
+
+    void MotionConstraints::start() {
+        obs_frontend_add_event_callback(on_frontend_event, this);
+    }
+
+    void MotionConstraints::stop() {
+        obs_frontend_remove_event_callback(on_frontend_event, this);
+        std::lock_guard lock(mutex_);
+        watch_scene({});
+        rules_.clear();
+        keep_out_names_.clear();
+        update_active();
+        index_dirty_.store(true, std::memory_order_release);
+    }
+
+    void MotionConstraints::on_frontend_event(const obs_frontend_event event, void* param) {
+        if (event == OBS_FRONTEND_EVENT_SCENE_CHANGED || event == OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED) {
+            static_cast<MotionConstraints*>(param)->index_dirty_.store(true, std::memory_order_release);
+        }
+    }
+
+    void MotionConstraints::on_item_signal(void* param, calldata_t*) {
+        static_cast<MotionConstraints*>(param)->index_dirty_.store(true, std::memory_order_release);
+    }
+
+    void MotionConstraints::on_item_transform(void* param, calldata_t* data) {
+        // Emitted for every moved item, the constrained ones included; only keep-out items invalidate the index
+        auto* self = static_cast<MotionConstraints*>(param);
+        const auto* item = data ? static_cast<const obs_sceneitem_t*>(calldata_ptr(data, "item")) : nullptr;
+        std::lock_guard lock(self->watch_mutex_);
+        if (item == nullptr || std::ranges::binary_search(self->watched_, item)) {
+            self->index_dirty_.store(true, std::memory_order_release);
+        }
+    }
+
+    void MotionConstraints::watch_scene(SourceRef scene_source) {
+        if (scene_source.get() == scene_source_.get()) {
+            return;
+        }
+
+        if (scene_source_) {
+            const auto handler = obs_source_get_signal_handler(scene_source_.get());
+            signal_handler_disconnect(handler, "item_add", on_item_signal, this);
+            signal_handler_disconnect(handler, "item_remove", on_item_signal, this);
+            signal_handler_disconnect(handler, "item_transform", on_item_transform, this);
+        }
+        scene_source_ = std::move(scene_source);
+        if (scene_source_) {
+            const auto handler = obs_source_get_signal_handler(scene_source_.get());
+            signal_handler_connect(handler, "item_add", on_item_signal, this);
+            signal_handler_connect(handler, "item_remove", on_item_signal, this);
+            signal_handler_connect(handler, "item_transform", on_item_transform, this);
+        }
+    }
+
+    void MotionConstraints::set_bounds(const String& item_name, const Rect bounds) {
+        std::lock_guard lock(mutex_);
+        rules_[item_name].bounds = bounds;
+        update_active();
+        log(LogLevel::INFO, "Bounds of \"{}\" set to ({}, {}) - ({}, {})", item_name, bounds.left, bounds.top,
+            bounds.right, bounds.bottom);
+    }
+
+    void MotionConstraints::set_locked(const String& item_name, const bool locked) {
+        std::lock_guard lock(mutex_);
+        rules_[item_name].locked = locked;
+        update_active();
+        log(LogLevel::INFO, "Position of \"{}\" {}", item_name, locked ? "locked" : "unlocked");
+    }
+
+    void MotionConstraints::set_keep_out(const String& item_name, const std::vector<String>& keep_out_names) {
+        std::lock_guard lock(mutex_);
+        auto& keep_out = rules_[item_name].keep_out;
+        keep_out.clear();
+        for (const auto& name : keep_out_names) {
+            if (name != item_name) {
+                keep_out.push_back(get_keep_out_id(name));
+            }
+        }
+        std::ranges::sort(keep_out);
+        update_active();
+        index_dirty_.store(true, std::memory_order_release);
+        log(LogLevel::INFO, "\"{}\" keeps out of {} scene item(s)", item_name, keep_out.size());
+    }
+
+    void MotionConstraints::clear(const String& item_name) {
+        std::lock_guard lock(mutex_);
+        rules_.erase(item_name);
+        update_active();
+    }
+
+    void MotionConstraints::update_active() {
+        std::erase_if(rules_, [](const auto& entry) {
+            const auto& rules = entry.second;
+            return !rules.bounds && !rules.locked && rules.keep_out.empty();
+        });
+        active_.store(!rules_.empty(), std::memory_order_release);
+
+        // Without keep-out rules the item signals are not needed; the next keep-out connects them again
+        if (std::ranges::none_of(rules_, [](const auto& entry) { return !entry.second.keep_out.empty(); })) {
+            watch_scene({});
+            index_dirty_.store(true, std::memory_order_release);
+        }
+    }
+
+    u32 MotionConstraints::get_keep_out_id(const String& name) {
+        const auto it = std::ranges::find(keep_out_names_, name);
+        if (it != keep_out_names_.end()) {
+            return static_cast<u32>(it - keep_out_names_.begin());
+        }
+        keep_out_names_.push_back(name);
+        return static_cast<u32>(keep_out_names_.size() - 1);
+    }
+
+    void MotionConstraints::rebuild_index() {
+        index_dirty_.store(false, std::memory_order_release);
+
+        auto scene_source = SourceRef::adopt(obs_frontend_get_current_scene());
+        const auto scene = scene_source ? obs_scene_from_source(scene_source.get()) : nullptr;
+        watch_scene(scene ? std::move(scene_source) : SourceRef());
+
+        std::vector<Rect> rects;
+        std::vector<const obs_sceneitem_t*> watched;
+        grid_owner_.clear();
+        for (u32 id = 0; scene != nullptr && id < keep_out_names_.size(); id++) {
+            const obs_sceneitem_t* item = obs_scene_find_source(scene, keep_out_names_[id].c_str());
+            if (item == nullptr) {
+                continue;
+            }
+
+            vec2 pos;
+            obs_sceneitem_get_pos(item, &pos);
+            const vec2 size = get_item_size(item);
+            rects.push_back({ pos.x, pos.y, pos.x + size.x, pos.y + size.y });
+            grid_owner_.push_back(id);
+            watched.push_back(item);
+        }
+        grid_.build(rects);
+
+        std::ranges::sort(watched);
+        std::lock_guard lock(watch_mutex_);
+        watched_ = std::move(watched);
+    }
+
+    vec2 MotionConstraints::constrain(obs_sceneitem_t* item, const vec2 from, const vec2 to) {
+        if (!is_active()) {
+            return to;
+        }
+
+        std::lock_guard lock(mutex_);
+        const auto it = rules_.find(StringView(obs_source_get_name(obs_sceneitem_get_source(item))));
+        if (it == rules_.end()) {
+            return to;
+        }
+
+        const Rules& rules = it->second;
+        if (rules.locked) {
+            return from;
+        }
+
+        const vec2 size = get_item_size(item);
+        vec2 result = to;
+        if (rules.bounds) {
+            // A box larger than the bounds is kept at their top left corner
+            const Rect& bounds = *rules.bounds;
+            result.x = std::max(bounds.left, std::min(result.x, bounds.right - size.x));
+            result.y = std::max(bounds.top, std::min(result.y, bounds.bottom - size.y));
+        }
+
+        if (!rules.keep_out.empty()) {
+            if (index_dirty_.load(std::memory_order_acquire)) {
+                rebuild_index();
+            }
+            result = sweep(rules, size, from, result);
+        }
+        return result;
+    }
+
+    vec2 MotionConstraints::sweep(const Rules& rules, const vec2 size, const vec2 from, const vec2 to) {
+        if (grid_.empty()) {
+            return to;
+        }
+
+        const Rect start = { from.x, from.y, from.x + size.x, from.y + size.y };
+        vec2 pos = from;
+        for (int axis = 0; axis < 2; axis++) {
+            const float origin = axis == 0 ? pos.x : pos.y;
+            float target = axis == 0 ? to.x : to.y;
+            if (target == origin) {
+                continue;
+            }
+
+            // The box swept along this axis from the current position to the target
+            Rect swept = { pos.x, pos.y, pos.x + size.x, pos.y + size.y };
+            if (axis == 0) {
+                swept.left = std::min(pos.x, to.x);
+                swept.right = std::max(pos.x, to.x) + size.x;
+            } else {
+                swept.top = std::min(pos.y, to.y);
+                swept.bottom = std::max(pos.y, to.y) + size.y;
+            }
+
+            grid_.query(swept, [&](const u32 index) {
+                const Rect& rect = grid_.get_rect(index);
+                if (!rect.overlaps(swept) || rect.overlaps(start)
+                    || !std::ranges::binary_search(rules.keep_out, grid_owner_[index])) {
+                    return;
+                }
+                if (axis == 0) {
+                    target = target > origin ? std::min(target, rect.left - size.x) : std::max(target, rect.right);
+                } else {
+                    target = target > origin ? std::min(target, rect.top - size.y) : std::max(target, rect.bottom);
+                }
+            });
+
+            (axis == 0 ? pos.x : pos.y) = target;
+        }
+        return pos;
+    }
+}
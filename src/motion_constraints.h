@@ -0,0 +1,160 @@
+#pragma once
+
+#include "prerequisites.h"
+#include "obs_ref.h"
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include <obs.h>
+#include <obs-frontend-api.h>
+
+namespace ObsCamMove {
+    //! Axis-aligned rectangle in scene coordinates.
+    struct Rect {
+        float left = 0.0f;
+        float top = 0.0f;
+        float right = 0.0f;
+        float bottom = 0.0f;
+
+        [[nodiscard]] bool overlaps(const Rect& other) const {
+            return left < other.right && other.left < right && top < other.bottom && other.top < bottom;
+        }
+    };
+
+    //! Uniform grid over a set of rectangles: a query only tests the rectangles in the cells it covers,
+    //! so its cost depends on the neighbourhood of the box rather than on the number of rectangles.
+    class RectGrid {
+    public:
+        //! Smallest cell size; cells grow beyond it when the rectangles are spread so far apart that the grid
+        //! would need more than MAX_CELLS cells.
+        static constexpr float CELL_SIZE = 256.0f;
+        static constexpr u32 MAX_CELLS = 4096;
+
+        void build(std::span<const Rect> rects);
+        [[nodiscard]] bool empty() const { return rects_.empty(); }
+        [[nodiscard]] usize cell_count() const { return static_cast<usize>(cols_) * rows_; }
+        [[nodiscard]] const Rect& get_rect(const u32 index) const { return rects_[index]; }
+
+        //! Calls visit(index) once for each rectangle that may overlap box.
+        template<typename Visit>
+        void query(const Rect& box, Visit&& visit) {
+            if (rects_.empty()) {
+                return;
+            }
+
+            const auto [first_col, last_col] = cell_range(box.left, box.right, origin_x_, cols_);
+            const auto [first_row, last_row] = cell_range(box.top, box.bottom, origin_y_, rows_);
+            if (first_col > last_col || first_row > last_row) {
+                return;
+            }
+
+            // A rectangle spanning several cells is listed in each; the stamp reports it only once
+            if (++stamp_ == 0) {
+                std::ranges::fill(visited_, 0);
+                stamp_ = 1;
+            }
+            for (u32 row = first_row; row <= last_row; row++) {
+                for (u32 col = first_col; col <= last_col; col++) {
+                    const u32 cell = row * cols_ + col;
+                    for (u32 k = cell_start_[cell]; k < cell_start_[cell + 1]; k++) {
+                        const u32 index = entries_[k];
+                        if (visited_[index] != stamp_) {
+                            visited_[index] = stamp_;
+                            visit(index);
+                        }
+                    }
+                }
+            }
+        }
+
+    private:
+        std::vector<Rect> rects_;
+        std::vector<u32> cell_start_; // Entries of cell c are entries_[cell_start_[c], cell_start_[c + 1])
+        std::vector<u32> entries_;
+        std::vector<u32> visited_;
+        u32 stamp_ = 0;
+        float origin_x_ = 0.0f;
+        float origin_y_ = 0.0f;
+        float cell_size_ = CELL_SIZE;
+        u32 cols_ = 0;
+        u32 rows_ = 0;
+
+        //! Cells covering [low, high) on one axis, clamped to the grid; first > last if there are none.
+        [[nodiscard]] std::pair<u32, u32> cell_range(float low, float high, float origin, u32 count) const;
+    };
+
+    //! Limits where scene items may move: bounds their box must stay within, a lock that keeps them in
+    //! place, and keep-out rectangles made from other scene items. Rules are kept per source name and
+    //! applied by the per-frame motion updates (animations, continuous control and follow).
+    class MotionConstraints {
+    public:
+        static MotionConstraints& get_instance() {
+            static MotionConstraints instance;
+            return instance;
+        }
+
+        //! Registers the frontend callback that marks the keep-out index stale after a scene change.
+        void start();
+        void stop();
+
+        void set_bounds(const String& item_name, Rect bounds);
+        void set_locked(const String& item_name, bool locked);
+        //! Keeps the item out of the boxes of the named scene items; an empty list removes the keep-out.
+        void set_keep_out(const String& item_name, const std::vector<String>& keep_out_names);
+        //! Removes all rules of the item.
+        void clear(const String& item_name);
+
+        //! False while there are no rules, so the motion updates can skip constrain() entirely.
+        [[nodiscard]] bool is_active() const { return active_.load(std::memory_order_acquire); }
+
+        //! Position the item may take on its way from its current position (from) to the requested one (to).
+        //! The box is swept one axis at a time and stops at keep-out rectangles, so the item slides along
+        //! them instead of jumping across; rectangles it already overlaps do not hold it back.
+        [[nodiscard]] vec2 constrain(obs_sceneitem_t* item, vec2 from, vec2 to);
+
+    private:
+        struct Rules {
+            std::optional<Rect> bounds;
+            bool locked = false;
+            std::vector<u32> keep_out; // Indices into keep_out_names_
+        };
+
+        struct StringHash {
+            using is_transparent = void;
+            usize operator()(const StringView value) const { return std::hash<StringView>{}(value); }
+        };
+
+        std::mutex mutex_;
+        std::unordered_map<String, Rules, StringHash, std::equal_to<>> rules_;
+        std::vector<String> keep_out_names_;
+        std::atomic_bool active_ = false;
+
+        // Keep-out index, rebuilt on the next constrain() after a keep-out item or the scene changed
+        RectGrid grid_;
+        std::vector<u32> grid_owner_;                // Keep-out name index of each rectangle in grid_
+        std::vector<const obs_sceneitem_t*> watched_; // Items in grid_, sorted; guarded by watch_mutex_
+        std::mutex watch_mutex_;
+        std::atomic_bool index_dirty_ = true;
+        SourceRef scene_source_; // Scene whose item signals mark the index dirty
+
+        MotionConstraints() = default;
+        MotionConstraints(MotionConstraints const&) = delete;
+        MotionConstraints& operator=(MotionConstraints const&) = delete;
+
+        static void on_frontend_event(obs_frontend_event event, void* param);
+        static void on_item_signal(void* param, calldata_t* data);
+        static void on_item_transform(void* param, calldata_t* data);
+        void watch_scene(SourceRef scene_source);
+        void rebuild_index();
+        void update_active();
+        [[nodiscard]] u32 get_keep_out_id(const String& name);
+        [[nodiscard]] vec2 sweep(const Rules& rules, vec2 size, vec2 from, vec2 to);
+    };
+
+    //! Size of the scene item's box, from its bounds or its scaled source size. Boxes assume the default
+    //! top-left alignment (the position is the top left corner) and ignore rotation.
+    [[nodiscard]] vec2 get_item_size(const obs_sceneitem_t* item);
+}
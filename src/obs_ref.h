@@ -0,0 +1,62 @@
+#pragma once
+
+#include <utility>
+#include <obs.h>
+
+namespace ObsCamMove {
+    //! Owning reference to a reference counted libobs object, released on destruction.
+    template<typename T, typename Traits>
+    class ObsRef {
+    public:
+        ObsRef() = default;
+
+        //! Takes an additional reference to ptr.
+        explicit ObsRef(T* ptr) : ptr_(ptr) {
+            if (ptr_) Traits::add_ref(ptr_);
+        }
+
+        //! Takes over a reference the caller already owns (e.g. from obs_frontend_get_current_scene).
+        static ObsRef adopt(T* ptr) {
+            ObsRef ref;
+            ref.ptr_ = ptr;
+            return ref;
+        }
+
+        ObsRef(const ObsRef& other) : ObsRef(other.ptr_) {}
+        ObsRef(ObsRef&& other) noexcept : ptr_(std::exchange(other.ptr_, nullptr)) {}
+
+        ObsRef& operator=(ObsRef other) noexcept {
+            std::swap(ptr_, other.ptr_);
+            return *this;
+        }
+
+        ~ObsRef() {
+            if (ptr_) Traits::release(ptr_);
+        }
+
+        [[nodiscard]] T* get() const { return ptr_; }
+        explicit operator bool() const { return ptr_ != nullptr; }
+
+    private:
+        T* ptr_ = nullptr;
+    };
+
+    struct SceneItemRefTraits {
+        static void add_ref(obs_sceneitem_t* item) { obs_sceneitem_addref(item); }
+        static void release(obs_sceneitem_t* item) { obs_sceneitem_release(item); }
+    };
+
+    struct SourceRefTraits {
+        static void add_ref(obs_source_t* source) { obs_source_get_ref(source); }
+        static void release(obs_source_t* source) { obs_source_release(source); }
+    };
+
+    struct DataRefTraits {
+        static void add_ref(obs_data_t* data) { obs_data_addref(data); }
+        static void release(obs_data_t* data) { obs_data_release(data); }
+    };
+
+    using SceneItemRef = ObsRef<obs_sceneitem_t, SceneItemRefTraits>;
+    using SourceRef = ObsRef<obs_source_t, SourceRefTraits>;
+    using DataRef = ObsRef<obs_data_t, DataRefTraits>;
+}
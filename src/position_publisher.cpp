@@ -0,0 +1,151 @@
+#include "position_publisher.h"
+#include "binary_protocol.h"
+#include "camera_controller.h"
+#include "logger.h"
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <obs.h>
+
+namespace ObsCamMove {
+    // Frame times jitter, so a rate that is a divisor of the frame rate (30 Hz at 60 fps) would
+    // otherwise often miss its frame and drop to the next lower divisor
+    static constexpr u64 RATE_TOLERANCE_NS = 2'000'000;
+    static constexpr float MIN_RATE_HZ = 1.0f;
+    static constexpr float DEFAULT_FRAME_RATE = 60.0f;
+
+    //! Updates are pushed with the video tick, so a rate above the frame rate has no effect.
+    static float get_frame_rate() {
+        obs_video_info info{};
+        if (!obs_get_video_info(&info) || info.fps_num == 0 || info.fps_den == 0) {
+            return DEFAULT_FRAME_RATE;
+        }
+        return static_cast<float>(info.fps_num) / static_cast<float>(info.fps_den);
+    }
+
+    void PositionPublisher::start() {
+        std::lock_guard lock(mutex_);
+        if (running_) {
+            return;
+        }
+
+        obs_add_tick_callback(on_video_tick, this);
+        running_ = true;
+        log_debug("Position publisher attached to video tick");
+    }
+
+    void PositionPublisher::stop() {
+        {
+            std::lock_guard lock(mutex_);
+            if (!running_) {
+                return;
+            }
+            running_ = false;
+        }
+
+        // Must not hold the mutex here: OBS waits for a running tick to finish
+        obs_remove_tick_callback(on_video_tick, this);
+
+        std::lock_guard lock(mutex_);
+        subscriptions_.clear();
+        updates_ = {};
+        version_ = 0;
+        all_pushed_ = false;
+        log_debug("Position publisher detached from video tick");
+    }
+
+    void PositionPublisher::subscribe(const std::weak_ptr<PositionSubscriber>& subscriber, const float rate_hz) {
+        const auto key = subscriber.lock().get();
+        if (key == nullptr) {
+            return;
+        }
+
+        // The lower bound also keeps 1e9 / rate in range of u64, which a tiny rate would overflow
+        const float max_rate = std::max(get_frame_rate(), MIN_RATE_HZ);
+        const float rate = std::isnan(rate_hz) ? max_rate : std::clamp(rate_hz, MIN_RATE_HZ, max_rate);
+
+        std::lock_guard lock(mutex_);
+        auto it = std::ranges::find(subscriptions_, key, &Subscription::key);
+        if (it == subscriptions_.end()) {
+            it = subscriptions_.insert(subscriptions_.end(), { subscriber, key });
+        }
+        it->min_interval_ns = static_cast<u64>(1e9 / rate);
+        all_pushed_ = false;
+    }
+
+    void PositionPublisher::unsubscribe(const PositionSubscriber* subscriber) {
+        std::lock_guard lock(mutex_);
+        std::erase_if(subscriptions_, [subscriber](const Subscription& subscription) {
+            return subscription.key == subscriber;
+        });
+    }
+
+    usize PositionPublisher::get_subscriber_count() {
+        std::lock_guard lock(mutex_);
+        return subscriptions_.size();
+    }
+
+    void PositionPublisher::on_video_tick(void* param, float) {
+        static_cast<PositionPublisher*>(param)->tick(obs_get_video_frame_time());
+    }
+
+    void PositionPublisher::tick(const u64 frame_time_ns) {
+        std::lock_guard lock(mutex_);
+        if (subscriptions_.empty()) {
+            return;
+        }
+
+        vec2 position;
+        if (!CameraController::getInstance().get_position(position)) {
+            return;
+        }
+        if (version_ == 0 || position.x != position_.x || position.y != position_.y) {
+            position_ = position;
+            version_++;
+            updates_ = {};
+            all_pushed_ = false;
+        }
+        if (all_pushed_) {
+            return;
+        }
+
+        all_pushed_ = true;
+        std::erase_if(subscriptions_, [&](Subscription& subscription) {
+            const auto subscriber = subscription.subscriber.lock();
+            if (!subscriber) {
+                return true;
+            }
+
+            const bool due = subscription.version == 0
+                || frame_time_ns + RATE_TOLERANCE_NS >= subscription.last_push_ns + subscription.min_interval_ns;
+            if (subscription.version != version_ && due) {
+                subscriber->push_update(get_update(subscriber->get_framing_mode()));
+                subscription.version = version_;
+                subscription.last_push_ns = frame_time_ns;
+            } else if (subscription.version != version_) {
+                all_pushed_ = false;
+            }
+            return false;
+        });
+    }
+
+    const std::shared_ptr<const String>& PositionPublisher::get_update(FramingMode mode) {
+        // Until the first '\n' arrives an Auto connection has no delimiter; updates always need one
+        if (mode == FramingMode::Auto) {
+            mode = FramingMode::Newline;
+        }
+
+        auto& update = updates_[static_cast<usize>(mode)];
+        if (!update) {
+            auto buffer = std::make_shared<String>();
+            if (mode == FramingMode::Binary) {
+                append_binary_reply(*buffer, static_cast<u8>(BinaryOpcode::SubscribePosition), position_);
+            } else {
+                MessageFramer::append_reply(*buffer, std::format("camera-position: x={}, y={}", position_.x, position_.y),
+                                            mode);
+            }
+            update = std::move(buffer);
+        }
+        return update;
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "prerequisites.h"
+#include "message_framer.h"
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <obs.h>
+
+namespace ObsCamMove {
+    //! Receiver of position updates, implemented by the connections.
+    class PositionSubscriber {
+    public:
+        virtual ~PositionSubscriber() = default;
+
+        [[nodiscard]] virtual FramingMode get_framing_mode() const = 0;
+        //! Called from the video thread with an update framed for get_framing_mode(). The buffer is shared
+        //! with all other subscribers and must not be modified.
+        virtual void push_update(std::shared_ptr<const String> update) = 0;
+    };
+
+    //! Pushes the webcam position to subscribed clients from the video tick, once per rendered frame at
+    //! most and only if it changed. Each update is serialized once per framing mode, however many
+    //! clients receive it.
+    class PositionPublisher {
+    public:
+        static PositionPublisher& get_instance() {
+            static PositionPublisher instance;
+            return instance;
+        }
+
+        void start();
+        void stop();
+
+        //! Sends the current position to the subscriber with the next frame, and then each change, but not
+        //! more often than rate_hz. The rate is clamped to 1 Hz up to the frame rate; subscribing again changes it.
+        void subscribe(const std::weak_ptr<PositionSubscriber>& subscriber, float rate_hz);
+        void unsubscribe(const PositionSubscriber* subscriber);
+        [[nodiscard]] usize get_subscriber_count();
+
+    private:
+        struct Subscription {
+            std::weak_ptr<PositionSubscriber> subscriber;
+            const PositionSubscriber* key = nullptr;
+            u64 min_interval_ns = 0;
+            u64 last_push_ns = 0;
+            u64 version = 0; // Position version last pushed, 0 if none yet
+        };
+
+        std::mutex mutex_;
+        std::vector<Subscription> subscriptions_;
+        bool running_ = false;
+        vec2 position_ = {};
+        u64 version_ = 0;
+        bool all_pushed_ = false; // Every subscriber has the current version
+        // Serialized update of the current version per framing mode, built when first needed
+        std::array<std::shared_ptr<const String>, 4> updates_;
+
+        PositionPublisher() = default;
+        PositionPublisher(PositionPublisher const&) = delete;
+        PositionPublisher& operator=(PositionPublisher const&) = delete;
+
+        static void on_video_tick(void* param, float seconds);
+        void tick(u64 frame_time_ns);
+        const std::shared_ptr<const String>& get_update(FramingMode mode);
+    };
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "prerequisites.h"
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace ObsCamMove {
+    //! Sequence lock for a small trivially copyable value with a single writer: readers never block the
+    //! writer and never take a lock, they retry the copy if a store overlapped it. The value is kept in
+    //! relaxed atomic words, so a torn read is detected rather than undefined behavior.
+    template<typename T>
+    class SeqLock {
+        static_assert(std::is_trivially_copyable_v<T>, "SeqLock values are copied word by word");
+
+    public:
+        SeqLock() { store(T{}); }
+
+        SeqLock(const SeqLock&) = delete;
+        SeqLock& operator=(const SeqLock&) = delete;
+
+        //! Publishes the value; only one thread may store at a time.
+        void store(const T& value) {
+            std::array<u64, WORD_COUNT> words{};
+            std::memcpy(words.data(), static_cast<const void*>(&value), sizeof(T));
+
+            const u64 sequence = sequence_.load(std::memory_order_relaxed);
+            sequence_.store(sequence + 1, std::memory_order_relaxed); // Odd while the words change
+            std::atomic_thread_fence(std::memory_order_release);
+            for (usize i = 0; i < WORD_COUNT; i++) {
+                words_[i].store(words[i], std::memory_order_relaxed);
+            }
+            sequence_.store(sequence + 2, std::memory_order_release);
+        }
+
+        //! Returns the value of the last completed store. Thread-safe and lock-free.
+        [[nodiscard]] T load() const {
+            std::array<u64, WORD_COUNT> words;
+            u64 sequence;
+            do {
+                sequence = sequence_.load(std::memory_order_acquire);
+                for (usize i = 0; i < WORD_COUNT; i++) {
+                    words[i] = words_[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+            } while ((sequence & 1) != 0 || sequence != sequence_.load(std::memory_order_relaxed));
+
+            T value;
+            std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+            return value;
+        }
+
+    private:
+        static constexpr usize WORD_COUNT = (sizeof(T) + sizeof(u64) - 1) / sizeof(u64);
+
+        alignas(64) std::atomic<u64> sequence_ = 0;
+        std::array<std::atomic<u64>, WORD_COUNT> words_{};
+    };
+}
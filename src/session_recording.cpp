@@ -0,0 +1,141 @@
+#include "session_recording.h"
+#include "logger.h"
+#include "metrics.h"
+#include <algorithm>
+#include <format>
+#include <iterator>
+
+namespace ObsCamMove {
+    static void append_varint(String& out, u64 value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    static bool read_varint(StringView& in, u64& value) {
+        value = 0;
+        for (u32 shift = 0; shift < 64 && !in.empty(); shift += 7) {
+            const auto byte = static_cast<u8>(in.front());
+            in.remove_prefix(1);
+            value |= static_cast<u64>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void append_record(String& out, const u32 connection, const u64 delta_us, const SessionMessageKind kind,
+                              const StringView payload) {
+        append_varint(out, connection);
+        append_varint(out, delta_us);
+        out.push_back(static_cast<char>(kind));
+        append_varint(out, payload.size());
+        out.append(payload);
+    }
+
+    bool write_session(const String& path, const std::vector<SessionRecord>& records, String& error) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            error = "Can't create session file " + path;
+            return false;
+        }
+
+        String out(SESSION_FILE_MAGIC);
+        u64 last_time_us = 0;
+        for (const auto& record : records) {
+            const u64 time_us = std::max(record.time_us, last_time_us);
+            append_record(out, record.connection, time_us - last_time_us, record.kind, record.payload);
+            last_time_us = time_us;
+        }
+
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+        if (!file) {
+            error = "Can't write session file " + path;
+            return false;
+        }
+        return true;
+    }
+
+    std::optional<std::vector<SessionRecord>> read_session(const String& path, String& error) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            error = "Can't open session file " + path;
+            return std::nullopt;
+        }
+        const String content{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+        if (!content.starts_with(SESSION_FILE_MAGIC)) {
+            error = path + " is not a session file";
+            return std::nullopt;
+        }
+
+        std::vector<SessionRecord> records;
+        StringView in(content);
+        in.remove_prefix(SESSION_FILE_MAGIC.size());
+        u64 time_us = 0;
+        while (!in.empty()) {
+            u64 connection = 0, delta_us = 0, size = 0;
+            if (!read_varint(in, connection) || !read_varint(in, delta_us) || in.empty()) {
+                error = std::format("Truncated record {} in {}", records.size() + 1, path);
+                return std::nullopt;
+            }
+            const auto kind = static_cast<SessionMessageKind>(in.front());
+            in.remove_prefix(1);
+            if (!read_varint(in, size) || size > in.size()
+                || (kind != SessionMessageKind::Text && kind != SessionMessageKind::Binary)) {
+                error = std::format("Invalid record {} in {}", records.size() + 1, path);
+                return std::nullopt;
+            }
+
+            time_us += delta_us;
+            records.push_back({ static_cast<u32>(connection), time_us, kind, String(in.substr(0, size)) });
+            in.remove_prefix(size);
+        }
+        return records;
+    }
+
+    bool SessionRecorder::start(const String& path) {
+        std::lock_guard lock(mutex_);
+        file_.close();
+        file_.clear();
+        file_.open(path, std::ios::binary | std::ios::trunc);
+        if (!file_) {
+            log(LogLevel::ERROR, "Can't create session file {}", path);
+            return false;
+        }
+
+        file_.write(SESSION_FILE_MAGIC.data(), static_cast<std::streamsize>(SESSION_FILE_MAGIC.size()));
+        start_ns_ = steady_clock_ns();
+        last_time_us_ = 0;
+        recording_.store(true, std::memory_order_relaxed);
+        log(LogLevel::INFO, "Recording the session to {}", path);
+        return true;
+    }
+
+    void SessionRecorder::stop() {
+        std::lock_guard lock(mutex_);
+        if (recording_.exchange(false, std::memory_order_relaxed)) {
+            file_.close();
+        }
+    }
+
+    void SessionRecorder::record(const u32 connection, const SessionMessageKind kind, const StringView payload) {
+        if (!is_recording()) {
+            return;
+        }
+
+        std::lock_guard lock(mutex_);
+        if (!file_.is_open()) {
+            return;
+        }
+
+        // Messages of other connections may have been recorded in between, so the delta is never negative
+        const u64 time_us = std::max((steady_clock_ns() - start_ns_) / 1000, last_time_us_);
+        buffer_.clear();
+        append_record(buffer_, connection, time_us - last_time_us_, kind, payload);
+        last_time_us_ = time_us;
+        file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    }
+}
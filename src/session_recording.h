@@ -0,0 +1,61 @@
+#pragma once
+
+#include "prerequisites.h"
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace ObsCamMove {
+    enum class SessionMessageKind : u8 {
+        Text   = 0,
+        Binary = 1, // One frame of the binary protocol, without the magic byte that selects it
+    };
+
+    struct SessionRecord {
+        u32 connection = 0;   // Connections are numbered in the order they were accepted
+        u64 time_us = 0;      // Since the start of the recording
+        SessionMessageKind kind = SessionMessageKind::Text;
+        String payload;       // The message without delimiter or length prefix
+    };
+
+    //! Session file: the 8 byte header SESSION_FILE_MAGIC, then per received message
+    //!   varint connection | varint microseconds since the previous record | u8 kind | varint size | payload
+    //! with unsigned LEB128 varints, so a typical command takes only a few bytes besides its text.
+    constexpr StringView SESSION_FILE_MAGIC{ "OCMREC\x01\x00", 8 };
+
+    [[nodiscard]] bool write_session(const String& path, const std::vector<SessionRecord>& records, String& error);
+    [[nodiscard]] std::optional<std::vector<SessionRecord>> read_session(const String& path, String& error);
+
+    //! Records the messages received by the server to a session file for a later replay.
+    class SessionRecorder {
+    public:
+        static SessionRecorder& get_instance() {
+            static SessionRecorder instance;
+            return instance;
+        }
+
+        bool start(const String& path);
+        void stop();
+
+        [[nodiscard]] bool is_recording() const { return recording_.load(std::memory_order_relaxed); }
+        //! Thread-safe; does nothing unless recording.
+        void record(u32 connection, SessionMessageKind kind, StringView payload);
+        //! Number for the next accepted connection.
+        [[nodiscard]] u32 next_connection_id() { return next_connection_.fetch_add(1, std::memory_order_relaxed); }
+
+    private:
+        std::mutex mutex_;
+        std::ofstream file_;
+        std::atomic_bool recording_ = false;
+        std::atomic<u32> next_connection_ = 0;
+        u64 start_ns_ = 0;
+        u64 last_time_us_ = 0;
+        String buffer_;
+
+        SessionRecorder() = default;
+        SessionRecorder(SessionRecorder const&) = delete;
+        SessionRecorder& operator=(SessionRecorder const&) = delete;
+    };
+}
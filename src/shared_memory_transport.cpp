@@ -0,0 +1,402 @@
+#include "shared_memory_transport.h"
+#include "logger.h"
+#include "metrics.h"
+#include "session_recording.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #define NOGDI // wingdi.h defines ERROR, which clashes with LogLevel::ERROR
+    #include <windows.h>
+#else
+    #include <cerrno>
+    #include <csignal>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #include <immintrin.h>
+#endif
+
+namespace ObsCamMove {
+    namespace {
+        constexpr u32 SEGMENT_MAGIC = 0x4f434d53; // "OCMS"
+        constexpr u32 SEGMENT_VERSION = 1;
+
+        // Backoff of the polling threads once nothing arrives: spinning keeps the round trip at a few
+        // hundred nanoseconds, yielding lets other threads run, and sleeping costs next to no CPU
+        constexpr auto SPIN_TIME = std::chrono::microseconds(200);
+        constexpr auto YIELD_TIME = std::chrono::milliseconds(5);
+        constexpr auto IDLE_SLEEP = std::chrono::milliseconds(1);
+        constexpr auto REPLY_TIMEOUT = std::chrono::seconds(5);
+
+        static_assert(std::atomic_ref<u64>::is_always_lock_free, "The rings need lock-free 64 bit atomics");
+        static_assert((SharedMemorySegment::RING_CAPACITY & (SharedMemorySegment::RING_CAPACITY - 1)) == 0,
+                      "The ring capacity must be a power of two");
+
+        void cpu_relax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+            _mm_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        }
+
+        //! Waits a little longer the longer the caller has been idle. With a single hardware thread spinning
+        //! would only delay the other side, so it yields right away.
+        void back_off(const std::chrono::steady_clock::time_point idle_since) {
+            static const bool can_spin = std::thread::hardware_concurrency() > 1;
+            const auto idle = std::chrono::steady_clock::now() - idle_since;
+            if (can_spin && idle < SPIN_TIME) {
+                cpu_relax();
+            } else if (idle < YIELD_TIME) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(IDLE_SLEEP);
+            }
+        }
+
+        u64 load_acquire(u64& value) {
+            return std::atomic_ref(value).load(std::memory_order_acquire);
+        }
+
+        void store_release(u64& value, const u64 new_value) {
+            std::atomic_ref(value).store(new_value, std::memory_order_release);
+        }
+
+        u64 current_process_id() {
+#ifdef _WIN32
+            return GetCurrentProcessId();
+#else
+            return static_cast<u64>(getpid());
+#endif
+        }
+
+        bool process_exists(const u64 process_id) {
+#ifdef _WIN32
+            const HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, static_cast<DWORD>(process_id));
+            if (process == nullptr) {
+                return false;
+            }
+            const bool running = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+            CloseHandle(process);
+            return running;
+#else
+            return kill(static_cast<pid_t>(process_id), 0) == 0 || errno != ESRCH;
+#endif
+        }
+
+        //! POSIX shared memory names start with a slash; Windows names must not contain one.
+        String native_name(const String& name) {
+#ifdef _WIN32
+            return "Local\\" + (name.starts_with('/') ? name.substr(1) : name);
+#else
+            return name.starts_with('/') ? name : "/" + name;
+#endif
+        }
+    }
+
+    // +++ SharedMemoryRing +++
+
+    bool SharedMemoryRing::try_write(const StringView message) const {
+        const usize size = sizeof(u32) + message.size();
+        const u64 write_index = control_->write_index; // Only written by this thread
+        const u64 read_index = load_acquire(control_->read_index);
+        if (size > capacity_ - (write_index - read_index)) {
+            return false;
+        }
+
+        const auto length = static_cast<u32>(message.size());
+        copy_in(write_index, &length, sizeof(length));
+        copy_in(write_index + sizeof(length), message.data(), message.size());
+        store_release(control_->write_index, write_index + size);
+        return true;
+    }
+
+    std::optional<u32> SharedMemoryRing::front_length() const {
+        const u64 read_index = control_->read_index;
+        const u64 available = load_acquire(control_->write_index) - read_index;
+        if (available == 0) {
+            return std::nullopt;
+        }
+
+        // Messages become visible complete, so anything else means the other process broke the ring
+        u32 length = 0;
+        if (available >= sizeof(length)) {
+            copy_out(read_index, &length, sizeof(length));
+        }
+        if (available > capacity_ || available < sizeof(length) || length > max_message_size()
+            || sizeof(length) + length > available) {
+            log(LogLevel::ERROR, "Shared memory ring holds no valid message; discarding its contents.");
+            clear();
+            return std::nullopt;
+        }
+        return length;
+    }
+
+    bool SharedMemoryRing::peek(String& message) const {
+        const auto length = front_length();
+        if (!length) {
+            return false;
+        }
+
+        message.resize(*length);
+        copy_out(control_->read_index + sizeof(u32), message.data(), *length);
+        return true;
+    }
+
+    void SharedMemoryRing::pop() const {
+        if (const auto length = front_length()) {
+            store_release(control_->read_index, control_->read_index + sizeof(u32) + *length);
+        }
+    }
+
+    bool SharedMemoryRing::try_read(String& message) const {
+        if (!peek(message)) {
+            return false;
+        }
+        pop();
+        return true;
+    }
+
+    bool SharedMemoryRing::empty() const {
+        return load_acquire(control_->write_index) == load_acquire(control_->read_index);
+    }
+
+    void SharedMemoryRing::clear() const {
+        store_release(control_->read_index, load_acquire(control_->write_index));
+    }
+
+    void SharedMemoryRing::copy_in(const u64 position, const void* source, const usize size) const {
+        const usize offset = position & (capacity_ - 1);
+        const usize first = std::min<usize>(size, capacity_ - offset);
+        std::memcpy(data_ + offset, source, first);
+        std::memcpy(data_, static_cast<const char*>(source) + first, size - first);
+    }
+
+    void SharedMemoryRing::copy_out(const u64 position, void* destination, const usize size) const {
+        const usize offset = position & (capacity_ - 1);
+        const usize first = std::min<usize>(size, capacity_ - offset);
+        std::memcpy(destination, data_ + offset, first);
+        std::memcpy(static_cast<char*>(destination) + first, data_, size - first);
+    }
+
+    // +++ SharedMemorySegment +++
+
+    struct SharedMemorySegment::Layout {
+        u32 magic;
+        u32 version;
+        u32 ring_capacity;
+        u64 client_process; // 0 while no client is attached
+        SharedMemoryRing::Control request_control;
+        SharedMemoryRing::Control reply_control;
+        char request_data[RING_CAPACITY];
+        char reply_data[RING_CAPACITY];
+    };
+
+    SharedMemorySegment::SharedMemorySegment(String name, const bool owner)
+        : name_(native_name(name)), owner_(owner) {}
+
+    std::unique_ptr<SharedMemorySegment> SharedMemorySegment::create(const String& name) {
+        std::unique_ptr<SharedMemorySegment> segment(new SharedMemorySegment(name, true));
+        segment->map(true);
+
+        Layout& layout = *segment->layout_;
+        std::memset(&layout, 0, offsetof(Layout, request_data));
+        layout.version = SEGMENT_VERSION;
+        layout.ring_capacity = RING_CAPACITY;
+        std::atomic_ref(layout.magic).store(SEGMENT_MAGIC, std::memory_order_release); // Ready for clients
+        return segment;
+    }
+
+    std::unique_ptr<SharedMemorySegment> SharedMemorySegment::attach(const String& name) {
+        std::unique_ptr<SharedMemorySegment> segment(new SharedMemorySegment(name, false));
+        segment->map(false);
+
+        Layout& layout = *segment->layout_;
+        if (std::atomic_ref(layout.magic).load(std::memory_order_acquire) != SEGMENT_MAGIC
+            || layout.version != SEGMENT_VERSION || layout.ring_capacity != RING_CAPACITY) {
+            throw std::runtime_error("Shared memory " + name + " is not a camera move segment of this version");
+        }
+
+        // A client that crashed does not detach, so its claim only counts while its process exists
+        std::atomic_ref client(layout.client_process);
+        u64 expected = client.load();
+        do {
+            if (expected != 0 && process_exists(expected)) {
+                throw std::runtime_error("Another client is attached to shared memory " + name);
+            }
+        } while (!client.compare_exchange_weak(expected, current_process_id()));
+
+        // Replies to requests a previous client left behind must not be taken for replies to ours
+        const auto deadline = std::chrono::steady_clock::now() + REPLY_TIMEOUT;
+        while (!segment->requests_.empty() && std::chrono::steady_clock::now() < deadline) {
+            segment->replies_.clear();
+            std::this_thread::yield();
+        }
+        segment->replies_.clear();
+        return segment;
+    }
+
+    void SharedMemorySegment::map(const bool create) {
+        const usize size = sizeof(Layout);
+#ifdef _WIN32
+        const HANDLE mapping = create
+            ? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(size), name_.c_str())
+            : OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name_.c_str());
+        if (mapping == nullptr) {
+            throw std::runtime_error("Cannot open shared memory " + name_ + ": error " + std::to_string(GetLastError()));
+        }
+        void* address = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (address == nullptr) {
+            CloseHandle(mapping);
+            throw std::runtime_error("Cannot map shared memory " + name_ + ": error " + std::to_string(GetLastError()));
+        }
+        mapping_ = mapping;
+#else
+        if (create) {
+            shm_unlink(name_.c_str()); // Left behind if OBS crashed
+        }
+        const int fd = shm_open(name_.c_str(), create ? O_CREAT | O_EXCL | O_RDWR : O_RDWR, 0600);
+        if (fd == -1) {
+            throw std::runtime_error("Cannot open shared memory " + name_ + ": " + std::strerror(errno));
+        }
+        if (create && ftruncate(fd, static_cast<off_t>(size)) == -1) {
+            const int error = errno;
+            close(fd);
+            shm_unlink(name_.c_str());
+            throw std::runtime_error("Cannot size shared memory " + name_ + ": " + std::strerror(error));
+        }
+        void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED) {
+            if (create) shm_unlink(name_.c_str());
+            throw std::runtime_error("Cannot map shared memory " + name_ + ": " + std::strerror(errno));
+        }
+#endif
+        layout_ = static_cast<Layout*>(address);
+        requests_ = SharedMemoryRing(&layout_->request_control, layout_->request_data, RING_CAPACITY);
+        replies_ = SharedMemoryRing(&layout_->reply_control, layout_->reply_data, RING_CAPACITY);
+    }
+
+    SharedMemorySegment::~SharedMemorySegment() {
+        if (layout_ == nullptr) {
+            return;
+        }
+
+        if (!owner_) {
+            u64 expected = current_process_id();
+            std::atomic_ref(layout_->client_process).compare_exchange_strong(expected, 0);
+        }
+#ifdef _WIN32
+        UnmapViewOfFile(layout_);
+        CloseHandle(mapping_);
+#else
+        munmap(layout_, sizeof(Layout));
+        if (owner_) {
+            shm_unlink(name_.c_str());
+        }
+#endif
+    }
+
+    // +++ SharedMemoryServer +++
+
+    SharedMemoryServer::SharedMemoryServer(String name)
+        : name_(std::move(name)), segment_(SharedMemorySegment::create(name_)) {}
+
+    SharedMemoryServer::~SharedMemoryServer() {
+        stop();
+    }
+
+    void SharedMemoryServer::start() {
+        if (bool expected = false; running_.compare_exchange_strong(expected, true)) {
+            thread_ = std::thread([this] { run(); });
+            log(LogLevel::INFO, "Shared memory transport started on {}", name_);
+        }
+    }
+
+    void SharedMemoryServer::stop() {
+        if (bool expected = true; running_.compare_exchange_strong(expected, false)) {
+            if (thread_.joinable()) {
+                thread_.join();
+            }
+            log(LogLevel::INFO, "Shared memory transport stopped.");
+        }
+    }
+
+    void SharedMemoryServer::run() {
+        const SharedMemoryRing& requests = segment_->requests();
+        const SharedMemoryRing& replies = segment_->replies();
+        auto& metrics = Metrics::get_instance();
+        auto& recorder = SessionRecorder::get_instance();
+        const u32 id = recorder.next_connection_id();
+        const MessageContext context; // Position updates need a connection to push them
+        String request;
+        String reply;
+
+        auto idle_since = std::chrono::steady_clock::now();
+        while (running_.load(std::memory_order_relaxed)) {
+            if (!requests.peek(request)) {
+                back_off(idle_since);
+                continue;
+            }
+
+            const u64 received_ns = steady_clock_ns();
+            if (recorder.is_recording()) {
+                recorder.record(id, SessionMessageKind::Text, request);
+            }
+            log_debug("Received data: {}", request);
+
+            const auto response = message_handler_.process_message(request, context);
+            reply = response.has_value() ? response.value() : "No response received for message: " + request;
+            if (reply.size() > replies.max_message_size()) {
+                reply = "Reply exceeds the shared memory ring";
+            }
+
+            // The request stays in the ring until its reply is written, see SharedMemorySegment::attach
+            const auto reply_since = std::chrono::steady_clock::now();
+            while (!replies.try_write(reply) && running_.load(std::memory_order_relaxed)) {
+                back_off(reply_since);
+            }
+            requests.pop();
+
+            metrics.receive_to_reply.record(steady_clock_ns() - received_ns);
+            metrics.messages.fetch_add(1, std::memory_order_relaxed);
+            idle_since = std::chrono::steady_clock::now();
+        }
+    }
+
+    // +++ SharedMemoryClient +++
+
+    SharedMemoryClient::SharedMemoryClient(const String& name)
+        : segment_(SharedMemorySegment::attach(name)) {}
+
+    const String& SharedMemoryClient::request(const StringView command) {
+        if (command.size() > segment_->requests().max_message_size()) {
+            throw std::runtime_error("Command exceeds the shared memory ring");
+        }
+
+        const auto sent = std::chrono::steady_clock::now();
+        while (!segment_->requests().try_write(command)) {
+            if (std::chrono::steady_clock::now() - sent > REPLY_TIMEOUT) {
+                throw std::runtime_error("The plugin does not read from shared memory");
+            }
+            back_off(sent);
+        }
+
+        while (!segment_->replies().try_read(reply_)) {
+            if (std::chrono::steady_clock::now() - sent > REPLY_TIMEOUT) {
+                throw std::runtime_error("The plugin does not reply through shared memory");
+            }
+            back_off(sent);
+        }
+        return reply_;
+    }
+}
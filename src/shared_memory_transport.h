@@ -0,0 +1,125 @@
+#pragma once
+
+#include "prerequisites.h"
+#include "message_handler.h"
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <thread>
+
+namespace ObsCamMove {
+    //! Lock-free single-producer/single-consumer queue of messages in memory shared by two processes.
+    //! Each message is a u32 length followed by its bytes, wrapping around at the end of the buffer.
+    //! The producer only writes write_index and the consumer only read_index; both only ever grow.
+    class SharedMemoryRing {
+    public:
+        struct alignas(64) Control {
+            u64 write_index;
+            alignas(64) u64 read_index; // On its own cache line, so producer and consumer do not contend
+        };
+
+        SharedMemoryRing() = default;
+        SharedMemoryRing(Control* control, char* data, u32 capacity)
+            : control_(control), data_(data), capacity_(capacity) {}
+
+        //! Appends the message; false if the ring has no room for it at the moment.
+        [[nodiscard]] bool try_write(StringView message) const;
+        //! Copies the oldest message into message without removing it; false if the ring is empty.
+        [[nodiscard]] bool peek(String& message) const;
+        //! Removes the oldest message, if any.
+        void pop() const;
+        //! Moves the oldest message into message; false if the ring is empty.
+        [[nodiscard]] bool try_read(String& message) const;
+        [[nodiscard]] bool empty() const;
+        //! Discards all messages; only the consumer may call this.
+        void clear() const;
+
+        [[nodiscard]] u32 max_message_size() const { return capacity_ - static_cast<u32>(sizeof(u32)); }
+
+    private:
+        Control* control_ = nullptr;
+        char* data_ = nullptr;
+        u32 capacity_ = 0; // Power of two
+
+        //! Length of the oldest message, nullopt if the ring is empty. The indices and lengths are written by
+        //! the other process, so a ring without a complete message of valid length is discarded instead.
+        [[nodiscard]] std::optional<u32> front_length() const;
+        void copy_in(u64 position, const void* source, usize size) const;
+        void copy_out(u64 position, void* destination, usize size) const;
+    };
+
+    //! Named shared memory holding a request ring (client to plugin) and a reply ring (plugin to client).
+    //! The plugin creates it; one client at a time attaches to it by name.
+    class SharedMemorySegment {
+    public:
+        //! Capacity of each ring in bytes.
+        static constexpr u32 RING_CAPACITY = 64 * 1024;
+
+        //! Creates the segment, replacing one left behind by a crash. Throws std::runtime_error on failure.
+        static std::unique_ptr<SharedMemorySegment> create(const String& name);
+        //! Opens the segment created by the plugin and claims it for this client. Throws std::runtime_error
+        //! if it does not exist or another client is attached.
+        static std::unique_ptr<SharedMemorySegment> attach(const String& name);
+
+        ~SharedMemorySegment();
+        SharedMemorySegment(const SharedMemorySegment&) = delete;
+        SharedMemorySegment& operator=(const SharedMemorySegment&) = delete;
+
+        [[nodiscard]] const SharedMemoryRing& requests() const { return requests_; }
+        [[nodiscard]] const SharedMemoryRing& replies() const { return replies_; }
+
+    private:
+        struct Layout;
+
+        String name_;
+        bool owner_;
+        Layout* layout_ = nullptr;
+#ifdef _WIN32
+        void* mapping_ = nullptr;
+#endif
+        SharedMemoryRing requests_;
+        SharedMemoryRing replies_;
+
+        SharedMemorySegment(String name, bool owner);
+        void map(bool create);
+    };
+
+    //! Serves the control protocol to a client attached to a shared memory segment, for the lowest
+    //! latency: a thread of its own polls the request ring, so no system call is involved on either side.
+    //! Each request is one text command (no newline needed) and gets one reply. The thread spins for a
+    //! while after each request and then backs off to sleeping, so an idle client costs little CPU.
+    class SharedMemoryServer {
+    public:
+        explicit SharedMemoryServer(String name);
+        ~SharedMemoryServer();
+
+        void start();
+        void stop();
+
+        [[nodiscard]] const String& get_name() const { return name_; }
+
+    private:
+        String name_;
+        std::unique_ptr<SharedMemorySegment> segment_;
+        MessageHandler message_handler_;
+        std::thread thread_;
+        std::atomic_bool running_{false};
+
+        void run();
+    };
+
+    //! Client side of a shared memory segment, for local clients written in C++ (and the benchmarks).
+    class SharedMemoryClient {
+    public:
+        //! Attaches to the segment; throws std::runtime_error if that fails.
+        explicit SharedMemoryClient(const String& name);
+
+        //! Sends the command and waits for its reply, which stays valid until the next request. Throws
+        //! std::runtime_error if the command does not fit into the ring or the plugin does not reply.
+        const String& request(StringView command);
+
+    private:
+        std::unique_ptr<SharedMemorySegment> segment_;
+        String reply_;
+    };
+}
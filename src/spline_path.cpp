@@ -0,0 +1,83 @@
+#include "spline_path.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ObsCamMove {
+    static vec2 unit_vector(const vec2 from, const vec2 to) {
+        const vec2 offset = { to.x - from.x, to.y - from.y };
+        const float length = std::hypot(offset.x, offset.y);
+        return length > 0.0f ? vec2{ offset.x / length, offset.y / length } : vec2{};
+    }
+
+    SplinePath::SplinePath(const std::span<const vec2> points) {
+        const usize count = points.size();
+        if (count < 2) {
+            const vec2 point = count == 1 ? points[0] : vec2{};
+            segments_.push_back({ point, {}, {}, {} });
+            lengths_.assign(SAMPLES_PER_SEGMENT + 1, 0.0f);
+            return;
+        }
+
+        // Uniform Catmull-Rom; the missing neighbours of the end points are mirrored
+        const auto point = [&](const std::ptrdiff_t index) -> vec2 {
+            if (index < 0) return { 2 * points[0].x - points[1].x, 2 * points[0].y - points[1].y };
+            if (index >= static_cast<std::ptrdiff_t>(count)) {
+                return { 2 * points[count - 1].x - points[count - 2].x, 2 * points[count - 1].y - points[count - 2].y };
+            }
+            return points[index];
+        };
+
+        segments_.reserve(count - 1);
+        for (usize i = 0; i + 1 < count; i++) {
+            const auto index = static_cast<std::ptrdiff_t>(i);
+            const vec2 p0 = point(index - 1), p1 = point(index), p2 = point(index + 1), p3 = point(index + 2);
+            segments_.push_back({
+                { p1.x, p1.y },
+                { 0.5f * (p2.x - p0.x), 0.5f * (p2.y - p0.y) },
+                { 0.5f * (2 * p0.x - 5 * p1.x + 4 * p2.x - p3.x), 0.5f * (2 * p0.y - 5 * p1.y + 4 * p2.y - p3.y) },
+                { 0.5f * (-p0.x + 3 * p1.x - 3 * p2.x + p3.x), 0.5f * (-p0.y + 3 * p1.y - 3 * p2.y + p3.y) },
+            });
+        }
+
+        // Arc-length table, built once so that each frame only needs a binary search
+        lengths_.reserve(segments_.size() * SAMPLES_PER_SEGMENT + 1);
+        lengths_.push_back(0.0f);
+        vec2 previous = start();
+        for (usize segment = 0; segment < segments_.size(); segment++) {
+            for (usize sample = 1; sample <= SAMPLES_PER_SEGMENT; sample++) {
+                const vec2 current = point_on_segment(segment, static_cast<float>(sample) / SAMPLES_PER_SEGMENT);
+                lengths_.push_back(lengths_.back() + std::hypot(current.x - previous.x, current.y - previous.y));
+                previous = current;
+            }
+        }
+
+        start_tangent_ = unit_vector(start(), point_on_segment(0, 1.0f / SAMPLES_PER_SEGMENT));
+        end_tangent_ = unit_vector(point_on_segment(segments_.size() - 1, 1.0f - 1.0f / SAMPLES_PER_SEGMENT), end());
+    }
+
+    vec2 SplinePath::point_on_segment(const usize segment, const float u) const {
+        const auto& [a, b, c, d] = segments_[segment];
+        return { a.x + u * (b.x + u * (c.x + u * d.x)), a.y + u * (b.y + u * (c.y + u * d.y)) };
+    }
+
+    vec2 SplinePath::point_at(const float t) const {
+        const float total = length();
+        const float distance = t * total;
+        if (t <= 0.0f || t >= 1.0f || total <= 0.0f) {
+            const vec2 anchor = t >= 1.0f ? end() : start();
+            const vec2 tangent = t >= 1.0f ? end_tangent_ : start_tangent_;
+            const float beyond = t >= 1.0f ? distance - total : distance;
+            return { anchor.x + tangent.x * beyond, anchor.y + tangent.y * beyond };
+        }
+
+        // Last sample at or before the distance, then linear interpolation of the curve parameter
+        const auto it = std::upper_bound(lengths_.begin(), lengths_.end(), distance);
+        const usize sample = std::min(static_cast<usize>(it - lengths_.begin()) - 1, lengths_.size() - 2);
+        const float sample_length = lengths_[sample + 1] - lengths_[sample];
+        const float fraction = sample_length > 0.0f ? (distance - lengths_[sample]) / sample_length : 0.0f;
+
+        const usize segment = sample / SAMPLES_PER_SEGMENT;
+        const float u = (static_cast<float>(sample % SAMPLES_PER_SEGMENT) + fraction) / SAMPLES_PER_SEGMENT;
+        return point_on_segment(segment, u);
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "prerequisites.h"
+#include <span>
+#include <vector>
+#include <obs.h>
+
+namespace ObsCamMove {
+    //! Catmull-Rom spline through a list of points, parameterized by arc length so that a linear
+    //! parameter moves at constant speed along the curve.
+    class SplinePath {
+    public:
+        //! Arc-length samples per segment; more samples make the speed more even.
+        static constexpr usize SAMPLES_PER_SEGMENT = 32;
+
+        //! Builds the spline through points (at least two); the first point is the start of the path.
+        explicit SplinePath(std::span<const vec2> points);
+
+        [[nodiscard]] float length() const { return lengths_.back(); }
+        [[nodiscard]] vec2 start() const { return point_on_segment(0, 0.0f); }
+        [[nodiscard]] vec2 end() const { return point_on_segment(segments_.size() - 1, 1.0f); }
+
+        //! Point at the fraction t of the arc length. Values outside [0, 1] (e.g. from elastic easing)
+        //! continue along the tangent at the start or end.
+        [[nodiscard]] vec2 point_at(float t) const;
+
+    private:
+        //! Cubic a + b·u + c·u² + d·u³ of one segment, u in [0, 1].
+        struct Segment {
+            vec2 a, b, c, d;
+        };
+
+        std::vector<Segment> segments_;
+        std::vector<float> lengths_; // Cumulative arc length at each sample
+        vec2 start_tangent_ = {};    // Unit tangents for extrapolation
+        vec2 end_tangent_ = {};
+
+        [[nodiscard]] vec2 point_on_segment(usize segment, float u) const;
+    };
+}
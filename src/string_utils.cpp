@@ -1,5 +1,6 @@
 #include "string_utils.h"
 #include <algorithm>
+#include <charconv>
 #include <locale>
 
 namespace ObsCamMove {
@@ -48,6 +49,17 @@ namespace ObsCamMove {
         return (start < end ? std::string(start, end) : "");
     }
 
+    StringView trim_view(StringView str) {
+        const auto is_space = [](const unsigned char c) { return std::isspace(c) != 0; };
+        while (!str.empty() && is_space(str.front())) {
+            str.remove_prefix(1);
+        }
+        while (!str.empty() && is_space(str.back())) {
+            str.remove_suffix(1);
+        }
+        return str;
+    }
+
     String join_strings(
         const std::vector<String>& strings,
         const String& delimiter,
@@ -86,4 +98,24 @@ namespace ObsCamMove {
         }
         return input;
     }
+
+    std::errc parse_int(StringView text, int& value) {
+        text = trim_view(text);
+        if (text.size() > 1 && text.front() == '+' && text[1] != '-') {
+            text.remove_prefix(1);
+        }
+
+        const auto [_, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return ec;
+    }
+
+    std::errc parse_float(StringView text, float& value) {
+        text = trim_view(text);
+        if (text.size() > 1 && text.front() == '+' && text[1] != '-') {
+            text.remove_prefix(1);
+        }
+
+        const auto [_, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return ec;
+    }
 }
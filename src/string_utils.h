@@ -1,6 +1,7 @@
 #pragma once
 
 #include "prerequisites.h"
+#include <system_error>
 
 namespace ObsCamMove {
     [[nodiscard]] bool isNullOrWhitespace(const String& str);
@@ -10,6 +11,7 @@ namespace ObsCamMove {
     [[nodiscard]] String padLeft(const String& input, size_t totalWidth, char paddingChar = ' ');
     [[nodiscard]] String padRight(const String& input, size_t totalWidth, char paddingChar = ' ');
     [[nodiscard]] String trim(const String& str);
+    [[nodiscard]] StringView trim_view(StringView str);
     [[nodiscard]] String join_strings(
         const std::vector<String>& strings,
         const String& delimiter = ", ",
@@ -20,4 +22,9 @@ namespace ObsCamMove {
         const std::function<const String(String)> &modifier = nullptr,
         bool allow_empty_strings = false);
     [[nodiscard]] String remove_quotes(const String& input, bool with_trim = false);
+    //! Parses a decimal integer with the same leniency as std::stoi (leading whitespace, '+' sign and
+    //! trailing characters are accepted) without allocating. Returns std::errc{} on success.
+    [[nodiscard]] std::errc parse_int(StringView text, int& value);
+    //! Parses a decimal number like 1.5 with the same leniency as parse_int.
+    [[nodiscard]] std::errc parse_float(StringView text, float& value);
 }
@@ -1,19 +1,35 @@
 #include "tcp_connection.h"
 #include "logger.h"
+#include "metrics.h"
+#include "session_recording.h"
 #include "string_utils.h"
+#include <type_traits>
 
 namespace ObsCamMove {
-    TCPConnection::TCPConnection(AsioTcpSocketPtr socket, DisconnectCallback disconnect_callback)
-        : socket_(std::move(socket)), buffer_(), disconnect_callback_(std::move(disconnect_callback)) {
+    template<typename Socket>
+    StreamConnection<Socket>::StreamConnection(std::shared_ptr<Socket> socket,
+                                               std::shared_ptr<const MessageHandler> message_handler,
+                                               DisconnectCallback disconnect_callback, const FramingMode framing_mode)
+        : socket_(std::move(socket)), framer_(framing_mode), disconnect_callback_(std::move(disconnect_callback)),
+          message_handler_(std::move(message_handler)),
+          id_(SessionRecorder::get_instance().next_connection_id()), framing_mode_(framing_mode) {
     }
 
-    void TCPConnection::start() {
-        const auto client_ep_address = socket_->remote_endpoint().address().to_string();
-        log(LogLevel::DEBUG, "Starting connection for client: " + client_ep_address);
+    template<typename Socket>
+    void StreamConnection<Socket>::start() {
+        if constexpr (std::is_same_v<Socket, asio::ip::tcp::socket>) {
+            log_debug("Starting connection for client: {}", socket_->remote_endpoint().address().to_string());
+        } else {
+            log_debug("Starting connection for local client");
+        }
+        context_.subscriber = this->weak_from_this();
         process_data();
     }
 
-    void TCPConnection::close() {
+    template<typename Socket>
+    void StreamConnection<Socket>::close() {
+        PositionPublisher::get_instance().unsubscribe(this);
+
         if (socket_ && socket_->is_open()) {
             asio::error_code ec;
             socket_->close(ec);
@@ -23,36 +39,64 @@ namespace ObsCamMove {
         }
 
         if (disconnect_callback_) {
-            disconnect_callback_(shared_from_this());
+            disconnect_callback_(this->shared_from_this());
         }
     }
 
-    void TCPConnection::process_data() {
-        auto self = shared_from_this(); // Prevents destruction of the current instance
-        socket_->async_read_some(asio::buffer(buffer_),
+    template<typename Socket>
+    void StreamConnection<Socket>::process_data() {
+        auto self = this->shared_from_this(); // Prevents destruction of the current instance
+        const auto read_buffer = framer_.prepare();
+        socket_->async_read_some(asio::buffer(read_buffer.data(), read_buffer.size()),
             [this, self](const asio::error_code& ec, const std::size_t bytes_transferred) {
             if (!ec) {
-                // Log received message
-                const auto message = std::make_shared<String>(trim(String(buffer_.data(), bytes_transferred)));
-                log(LogLevel::DEBUG, "Received data: " + *message);
+                framer_.commit(bytes_transferred);
 
-                // +++ Parse message and send response to client +++
-                std::shared_ptr<String> client_response = nullptr;
-
-                if (const auto response = message_handler_.process_message(*message); response.has_value()) {
-                    client_response = std::make_shared<String>(response.value());
-                } else {
-                    client_response = std::make_shared<String>("No response received for message: " + *message);
-                }
+                // +++ Parse all complete messages and send the responses to the client +++
+                auto& metrics = Metrics::get_instance();
+                auto& recorder = SessionRecorder::get_instance();
+                const u64 received_ns = steady_clock_ns();
+                String client_response = write_queue_.acquire();
+                while (const auto message = framer_.next_message()) {
+                    const bool binary = framer_.get_mode() == FramingMode::Binary;
+                    if (recorder.is_recording()) {
+                        recorder.record(id_, binary ? SessionMessageKind::Binary : SessionMessageKind::Text, *message);
+                    }
 
-                async_write(*socket_, asio::buffer(*client_response),
-                    [this, self, client_response](const asio::error_code& ec2, const std::size_t) {
-                    if (ec2) {
-                        log(LogLevel::ERROR, "Error writing to socket: " + ec2.message());
+                    if (binary) {
+                        message_handler_->process_binary_message(*message, client_response, context_);
                     } else {
-                        log(LogLevel::DEBUG, "Data successful send: " + *client_response);
+                        log_debug("Received data: {}", *message);
+
+                        const auto response = message_handler_->process_message(*message, context_);
+                        if (response.has_value()) {
+                            framer_.append_reply(client_response, response.value());
+                        } else {
+                            framer_.append_reply(client_response, "No response received for message: " + String(*message));
+                        }
                     }
-                });
+
+                    // Messages of one read wait for each other, so their latency includes that queueing
+                    metrics.receive_to_reply.record(steady_clock_ns() - received_ns);
+                    metrics.messages.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                framing_mode_.store(framer_.get_mode(), std::memory_order_relaxed);
+
+                if (framer_.overflowed()) {
+                    log(LogLevel::ERROR, "Message exceeds the maximum size; closing connection.");
+                    close();
+                    return;
+                }
+
+                // Sent right away, or together with other queued replies once the write in flight is done
+                write_queue_.push(std::move(client_response));
+                if (write_queue_.overflowed()) {
+                    log(LogLevel::ERROR, "Client does not read its replies; closing connection.");
+                    close();
+                    return;
+                }
+                write_pending();
 
                 // Read more data
                 process_data();
@@ -65,4 +109,45 @@ namespace ObsCamMove {
             }
         });
     }
+
+    template<typename Socket>
+    void StreamConnection<Socket>::write_pending() {
+        const auto& buffers = write_queue_.begin_write();
+        if (buffers.empty()) {
+            return;
+        }
+
+        auto self = this->shared_from_this();
+        async_write(*socket_, buffers, [this, self](const asio::error_code& ec, const std::size_t bytes_transferred) {
+            write_queue_.end_write();
+            if (ec) {
+                log(LogLevel::ERROR, "Error writing to socket: " + ec.message());
+                return;
+            }
+
+            log_debug("Data successful send: {} bytes", bytes_transferred);
+            write_pending();
+        });
+    }
+
+    template<typename Socket>
+    FramingMode StreamConnection<Socket>::get_framing_mode() const {
+        return framing_mode_.load(std::memory_order_relaxed);
+    }
+
+    template<typename Socket>
+    void StreamConnection<Socket>::push_update(std::shared_ptr<const String> update) {
+        asio::post(socket_->get_executor(), [this, self = this->shared_from_this(), update = std::move(update)]() mutable {
+            if (!socket_->is_open()) {
+                return;
+            }
+            write_queue_.push_latest(std::move(update));
+            write_pending();
+        });
+    }
+
+    template class StreamConnection<asio::ip::tcp::socket>;
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+    template class StreamConnection<asio::local::stream_protocol::socket>;
+#endif
 }
@@ -2,26 +2,56 @@
 
 #include "prerequisites.h"
 #include "message_handler.h"
+#include "message_framer.h"
+#include "write_queue.h"
+#include "position_publisher.h"
+#include <atomic>
 
 namespace ObsCamMove {
-    class TCPConnection;
-    typedef std::shared_ptr<TCPConnection> TCPConnectionPtr;
+    class Connection;
+    typedef std::shared_ptr<Connection> ConnectionPtr;
+
+    //! A client connection of the server, whatever its transport.
+    class Connection : public PositionSubscriber {
+    public:
+        using DisconnectCallback = std::function<void(const ConnectionPtr&)>;
+
+        virtual void start() = 0;
+        virtual void close() = 0;
+    };
 
-    class TCPConnection : public std::enable_shared_from_this<TCPConnection> {
+    //! Connection over a stream socket: TCP, or a Unix domain socket for local clients.
+    template<typename Socket>
+    class StreamConnection : public Connection, public std::enable_shared_from_this<StreamConnection<Socket>> {
     public:
-        using DisconnectCallback = std::function<void(const TCPConnectionPtr&)>;
+        StreamConnection(std::shared_ptr<Socket> socket, std::shared_ptr<const MessageHandler> message_handler,
+                         DisconnectCallback disconnect_callback, FramingMode framing_mode = FramingMode::Auto);
 
-        explicit TCPConnection(AsioTcpSocketPtr socket, DisconnectCallback disconnect_callback);
+        void start() override;
+        void close() override;
 
-        void start();
-        void close();
+        [[nodiscard]] FramingMode get_framing_mode() const override;
+        //! Thread-safe: the update is queued on the connection's strand.
+        void push_update(std::shared_ptr<const String> update) override;
 
     private:
-        AsioTcpSocketPtr socket_;
-        std::array<char, 1024> buffer_;
+        std::shared_ptr<Socket> socket_;
+        MessageFramer framer_;
         DisconnectCallback disconnect_callback_;
-        MessageHandler message_handler_;
+        std::shared_ptr<const MessageHandler> message_handler_;
+        WriteQueue write_queue_;
+        MessageContext context_;
+        u32 id_; // Identifies the connection in a recorded session
+        std::atomic<FramingMode> framing_mode_; // Copy of the framer's mode for other threads
 
         void process_data();
+        void write_pending();
     };
+
+    using TCPConnection = StreamConnection<asio::ip::tcp::socket>;
+    typedef std::shared_ptr<TCPConnection> TCPConnectionPtr;
+
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+    using LocalConnection = StreamConnection<asio::local::stream_protocol::socket>;
+#endif
 }
@@ -2,14 +2,51 @@
 #include "tcp_server.h"
 #include "logger.h"
 #include "tcp_connection.h"
+#include <algorithm>
+#include <filesystem>
 #include <mutex>
 
+#ifndef _WIN32
+    #include <sys/stat.h>
+#endif
+
 static std::mutex server_lock;
 
 namespace ObsCamMove {
-    TCPServer::TCPServer(const uint16_t port)
-        : acceptor_(io_context_, asio::ip::tcp::endpoint(asio::ip::tcp::v4(), port)),
-          running_(false) {}
+    TCPServer::TCPServer(const uint16_t port, const FramingMode framing_mode, const usize thread_count,
+                         const String& socket_path)
+        : io_context_(static_cast<int>(std::max<usize>(thread_count, 1))),
+          acceptor_(io_context_, asio::ip::tcp::endpoint(asio::ip::tcp::v4(), port)),
+          thread_count_(std::max<usize>(thread_count, 1)), running_(false), framing_mode_(framing_mode),
+          message_handler_(std::make_shared<const MessageHandler>()) {
+        if (socket_path.empty()) {
+            return;
+        }
+
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+        // A socket file still exists if the previous process did not stop the server; binding would fail
+        std::error_code fs_error;
+        if (std::filesystem::is_socket(socket_path, fs_error)) {
+            std::filesystem::remove(socket_path, fs_error);
+        }
+
+        {
+            // Only the user running OBS may connect, like only localhost may connect over TCP. The socket file
+            // is created with these permissions by bind; changing them afterwards would leave a window open.
+#ifndef _WIN32
+            struct UmaskGuard {
+                mode_t previous = umask(0177);
+                ~UmaskGuard() { umask(previous); }
+            } umask_guard;
+#endif
+            local_acceptor_.emplace(io_context_, asio::local::stream_protocol::endpoint(socket_path));
+        }
+        socket_path_ = socket_path;
+#else
+        log(LogLevel::WARN, "Unix domain sockets are not supported on this platform; ignoring socket path {}",
+            socket_path);
+#endif
+    }
 
     TCPServer::~TCPServer() {
         stop();
@@ -20,17 +57,23 @@ namespace ObsCamMove {
 
         // Start accepting connections
         accept_connection();
+        accept_local_connection();
 
-        // Start the io_context thread
-        server_thread_ = std::thread([this] {
-            try {
-                io_context_.run();
-            } catch (const std::exception& e) {
-                log(LogLevel::ERROR, std::string("Server error: ") + e.what());
-            }
-        });
+        // Start the io_context threads
+        for (usize i = 0; i < thread_count_; i++) {
+            server_threads_.emplace_back([this] {
+                try {
+                    io_context_.run();
+                } catch (const std::exception& e) {
+                    log(LogLevel::ERROR, std::string("Server error: ") + e.what());
+                }
+            });
+        }
 
-        log(LogLevel::INFO, std::string("Server started on port ") + std::to_string(acceptor_.local_endpoint().port()));
+        log(LogLevel::INFO, "Server started on port {} with {} thread(s)", get_port(), thread_count_);
+        if (!socket_path_.empty()) {
+            log(LogLevel::INFO, "Server listening on local socket {}", socket_path_);
+        }
     }
 
     void TCPServer::stop() {
@@ -38,8 +81,23 @@ namespace ObsCamMove {
 
         if (bool expected = true; running_.compare_exchange_strong(expected, false)) {
             io_context_.stop();
-            if (server_thread_.joinable()) {
-                server_thread_.join();
+            for (auto& thread : server_threads_) {
+                if (thread.joinable()) {
+                    thread.join();
+                }
+            }
+            server_threads_.clear();
+
+            std::lock_guard connections_lock(connections_mutex_);
+            connections_.clear();
+
+            if (!socket_path_.empty()) {
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+                asio::error_code ec;
+                local_acceptor_->close(ec);
+#endif
+                std::error_code fs_error;
+                std::filesystem::remove(socket_path_, fs_error);
             }
             log(LogLevel::INFO, std::string("Server stopped."));
         } else {
@@ -48,8 +106,8 @@ namespace ObsCamMove {
     }
 
     void TCPServer::accept_connection() {
-        // Create a new socket for the incoming connection
-        auto socket = std::make_shared<asio::ip::tcp::socket>(io_context_);
+        // Create a new socket for the incoming connection; its handlers run on a strand of its own
+        auto socket = std::make_shared<asio::ip::tcp::socket>(asio::make_strand(io_context_));
         acceptor_.async_accept(*socket, [this, socket](const asio::error_code& ec) {
             if (!ec) {
                 // Check whether the connection is coming from localhost
@@ -61,12 +119,7 @@ namespace ObsCamMove {
                     oss << "Client Connection from " << socket->remote_endpoint();
                     log(LogLevel::INFO, oss.str());
 
-                    const auto connection = std::make_shared<TCPConnection>(socket,
-                        [this](const TCPConnectionPtr& conn) {
-                        remove_connection(conn);
-                    });
-                    connections_.push_back(connection);
-                    connection->start();
+                    add_connection<TCPConnection>(socket);
                 } else {
                     log(LogLevel::WARN, "Rejected connection from: " + remote_address);
                     socket->close();
@@ -82,8 +135,55 @@ namespace ObsCamMove {
         });
     }
 
-    void TCPServer::remove_connection(const TCPConnectionPtr& connection) {
+    void TCPServer::accept_local_connection() {
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+        if (!local_acceptor_) {
+            return;
+        }
+
+        // The socket file is only accessible to the owner, so there is no address to check
+        auto socket = std::make_shared<asio::local::stream_protocol::socket>(asio::make_strand(io_context_));
+        local_acceptor_->async_accept(*socket, [this, socket](const asio::error_code& ec) {
+            if (!ec) {
+                log(LogLevel::INFO, "Client Connection on local socket {}", socket_path_);
+                add_connection<LocalConnection>(socket);
+            } else if (ec != asio::error::operation_aborted) {
+                log(LogLevel::ERROR, std::string("Accepted error: ") + ec.message());
+            }
+
+            if (running_.load()) {
+                accept_local_connection();
+            }
+        });
+#endif
+    }
+
+    template<typename ConnectionType, typename Socket>
+    void TCPServer::add_connection(const std::shared_ptr<Socket>& socket) {
+        const auto connection = std::make_shared<ConnectionType>(socket, message_handler_,
+            [this](const ConnectionPtr& conn) {
+            remove_connection(conn);
+        }, framing_mode_);
+        {
+            std::lock_guard lock(connections_mutex_);
+            connections_.insert(connection);
+        }
+        // Starts on the connection's strand, not on the acceptor's thread
+        asio::dispatch(socket->get_executor(), [connection] { connection->start(); });
+    }
+
+    void TCPServer::remove_connection(const ConnectionPtr& connection) {
         log(LogLevel::INFO, "Removing connection");
-        std::erase(connections_, connection);
+        std::lock_guard lock(connections_mutex_);
+        connections_.erase(connection);
+    }
+
+    uint16_t TCPServer::get_port() const {
+        return acceptor_.local_endpoint().port();
+    }
+
+    usize TCPServer::get_connection_count() {
+        std::lock_guard lock(connections_mutex_);
+        return connections_.size();
     }
 }
@@ -5,6 +5,10 @@
 #include <functional>
 #include <memory>
 #include <atomic>
+#include <mutex>
+#include <optional>
+#include <unordered_set>
+#include <vector>
 
 #include "tcp_connection.h"
 
@@ -13,20 +17,44 @@ namespace ObsCamMove {
     public:
         using ClientHandler = std::function<void(const std::string&, std::string&)>;
 
-        explicit TCPServer(uint16_t port);
+        //! Serves the control protocol on port (0 picks a free port) with a pool of thread_count
+        //! threads; each connection runs on its own strand, so its handlers never run concurrently. With a
+        //! socket_path, local clients can also connect through a Unix domain socket at that path, which
+        //! skips the TCP loopback stack; a stale socket file left behind by a crash is replaced.
+        explicit TCPServer(uint16_t port, FramingMode framing_mode = FramingMode::Auto, usize thread_count = 1,
+                           const String& socket_path = {});
         ~TCPServer();
 
         void start();
         void stop();
 
+        [[nodiscard]] uint16_t get_port() const;
+        //! Path of the Unix domain socket, empty if the server does not listen on one.
+        [[nodiscard]] const String& get_socket_path() const { return socket_path_; }
+        [[nodiscard]] usize get_connection_count();
+
     private:
         asio::io_context io_context_;
         asio::ip::tcp::acceptor acceptor_;
-        std::thread server_thread_;
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+        std::optional<asio::local::stream_protocol::acceptor> local_acceptor_;
+#endif
+        String socket_path_;
+        std::vector<std::thread> server_threads_;
+        usize thread_count_;
         std::atomic_bool running_;
-        std::vector<TCPConnectionPtr> connections_;
+        FramingMode framing_mode_;
+        // Shared by all connections; the handler registry is only read after construction
+        std::shared_ptr<const MessageHandler> message_handler_;
+
+        std::mutex connections_mutex_;
+        std::unordered_set<ConnectionPtr> connections_;
 
         void accept_connection();
-        void remove_connection(const TCPConnectionPtr& connection);
+        void accept_local_connection();
+        //! Registers the connection and starts it on its strand.
+        template<typename ConnectionType, typename Socket>
+        void add_connection(const std::shared_ptr<Socket>& socket);
+        void remove_connection(const ConnectionPtr& connection);
     };
 }
@@ -0,0 +1,141 @@
+#include "transform_channels.h"
+#include "obs_ref.h"
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+namespace ObsCamMove {
+    // Scene items have no opacity of their own; it is applied by a color filter on their source
+    static constexpr const char* OPACITY_FILTER_ID = "color_filter_v2";
+    static constexpr const char* OPACITY_FILTER_NAME = "Camera Move Opacity";
+    static constexpr const char* OPACITY_SETTING = "opacity";
+
+    static constexpr std::array<StringView, TRANSFORM_CHANNEL_COUNT> CHANNEL_NAMES = {
+        "x", "y", "scale_x", "scale_y", "rotation", "crop_left", "crop_top", "crop_right", "crop_bottom", "opacity",
+    };
+
+    std::optional<TransformChannel> to_transform_channel(const StringView name) {
+        for (usize i = 0; i < CHANNEL_NAMES.size(); i++) {
+            if (CHANNEL_NAMES[i] == name) {
+                return static_cast<TransformChannel>(i);
+            }
+        }
+        return std::nullopt;
+    }
+
+    //! Number of scene items in all scenes that show the source.
+    static usize count_scene_items(const obs_source_t* source) {
+        struct Search {
+            const obs_source_t* source;
+            usize count = 0;
+        } search{ source };
+
+        obs_enum_scenes([](void* param, obs_source_t* scene_source) {
+            obs_scene_enum_items(obs_scene_from_source(scene_source), [](obs_scene_t*, obs_sceneitem_t* item, void* param) {
+                auto& search = *static_cast<Search*>(param);
+                search.count += obs_sceneitem_get_source(item) == search.source;
+                return true;
+            }, param);
+            return true;
+        }, &search);
+        return search.count;
+    }
+
+    std::optional<OpacityFilter> get_opacity_filter(obs_sceneitem_t* item, String& error) {
+        obs_source_t* source = obs_sceneitem_get_source(item);
+        if (source == nullptr) {
+            error = "Scene item has no source";
+            return std::nullopt;
+        }
+        if (count_scene_items(source) > 1) {
+            error = std::format("Source \"{}\" is shown by more than one scene item; fading it would fade all of them",
+                                obs_source_get_name(source));
+            return std::nullopt;
+        }
+
+        OpacityFilter result;
+        result.filter = SourceRef::adopt(obs_source_get_filter_by_name(source, OPACITY_FILTER_NAME));
+        if (!result.filter) {
+            const auto settings = DataRef::adopt(obs_data_create());
+            obs_data_set_double(settings.get(), OPACITY_SETTING, 1.0);
+            result.filter = SourceRef::adopt(obs_source_create_private(OPACITY_FILTER_ID, OPACITY_FILTER_NAME,
+                                                                       settings.get()));
+            if (!result.filter) {
+                error = std::format("Can't create the opacity filter for source \"{}\"", obs_source_get_name(source));
+                return std::nullopt;
+            }
+            obs_source_filter_add(source, result.filter.get());
+        }
+        result.settings = DataRef::adopt(obs_data_create());
+        return result;
+    }
+
+    TransformValues read_transform(obs_sceneitem_t* item, const ChannelMask mask) {
+        TransformValues result;
+        if (mask & POSITION_CHANNELS) {
+            vec2 pos;
+            obs_sceneitem_get_pos(item, &pos);
+            result.set(TransformChannel::PosX, pos.x);
+            result.set(TransformChannel::PosY, pos.y);
+        }
+        if (mask & SCALE_CHANNELS) {
+            vec2 scale;
+            obs_sceneitem_get_scale(item, &scale);
+            result.set(TransformChannel::ScaleX, scale.x);
+            result.set(TransformChannel::ScaleY, scale.y);
+        }
+        if (mask & channel_bit(TransformChannel::Rotation)) {
+            result.set(TransformChannel::Rotation, obs_sceneitem_get_rot(item));
+        }
+        if (mask & CROP_CHANNELS) {
+            obs_sceneitem_crop crop;
+            obs_sceneitem_get_crop(item, &crop);
+            result.set(TransformChannel::CropLeft, static_cast<float>(crop.left));
+            result.set(TransformChannel::CropTop, static_cast<float>(crop.top));
+            result.set(TransformChannel::CropRight, static_cast<float>(crop.right));
+            result.set(TransformChannel::CropBottom, static_cast<float>(crop.bottom));
+        }
+        if (mask & channel_bit(TransformChannel::Opacity)) {
+            float opacity = 1.0f;
+            obs_source_t* source = obs_sceneitem_get_source(item);
+            const auto filter = source ? SourceRef::adopt(obs_source_get_filter_by_name(source, OPACITY_FILTER_NAME))
+                                       : SourceRef();
+            if (filter) {
+                const auto settings = DataRef::adopt(obs_source_get_settings(filter.get()));
+                opacity = static_cast<float>(obs_data_get_double(settings.get(), OPACITY_SETTING));
+            }
+            result.set(TransformChannel::Opacity, opacity);
+        }
+        return result;
+    }
+
+    void apply_transform(obs_sceneitem_t* item, const TransformValues& values, const OpacityFilter* opacity) {
+        const ChannelMask mask = values.mask;
+        if (mask & POSITION_CHANNELS) {
+            const vec2 pos = { values.get(TransformChannel::PosX), values.get(TransformChannel::PosY) };
+            obs_sceneitem_set_pos(item, &pos);
+        }
+        if (mask & SCALE_CHANNELS) {
+            const vec2 scale = { values.get(TransformChannel::ScaleX), values.get(TransformChannel::ScaleY) };
+            obs_sceneitem_set_scale(item, &scale);
+        }
+        if (mask & channel_bit(TransformChannel::Rotation)) {
+            obs_sceneitem_set_rot(item, values.get(TransformChannel::Rotation));
+        }
+        if (mask & CROP_CHANNELS) {
+            const auto to_pixels = [&](const TransformChannel channel) {
+                return static_cast<int>(std::lround(std::max(0.0f, values.get(channel))));
+            };
+            const obs_sceneitem_crop crop = {
+                to_pixels(TransformChannel::CropLeft), to_pixels(TransformChannel::CropTop),
+                to_pixels(TransformChannel::CropRight), to_pixels(TransformChannel::CropBottom),
+            };
+            obs_sceneitem_set_crop(item, &crop);
+        }
+        if ((mask & channel_bit(TransformChannel::Opacity)) && opacity != nullptr && opacity->filter) {
+            obs_data_set_double(opacity->settings.get(), OPACITY_SETTING,
+                                std::clamp(values.get(TransformChannel::Opacity), 0.0f, 1.0f));
+            obs_source_update(opacity->filter.get(), opacity->settings.get());
+        }
+    }
+}
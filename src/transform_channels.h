@@ -0,0 +1,81 @@
+#pragma once
+
+#include "prerequisites.h"
+#include "obs_ref.h"
+#include <array>
+#include <optional>
+#include <obs.h>
+
+namespace ObsCamMove {
+    //! Animatable properties of a scene item: position and crop in pixels, rotation in degrees, opacity
+    //! from 0 (transparent) to 1.
+    enum class TransformChannel : u8 {
+        PosX,
+        PosY,
+        ScaleX,
+        ScaleY,
+        Rotation,
+        CropLeft,
+        CropTop,
+        CropRight,
+        CropBottom,
+        Opacity,
+    };
+
+    constexpr usize TRANSFORM_CHANNEL_COUNT = 10;
+
+    using ChannelMask = u16;
+
+    constexpr ChannelMask channel_bit(const TransformChannel channel) {
+        return static_cast<ChannelMask>(1u << static_cast<u32>(channel));
+    }
+
+    constexpr ChannelMask POSITION_CHANNELS = channel_bit(TransformChannel::PosX) | channel_bit(TransformChannel::PosY);
+    constexpr ChannelMask SCALE_CHANNELS = channel_bit(TransformChannel::ScaleX) | channel_bit(TransformChannel::ScaleY);
+    constexpr ChannelMask CROP_CHANNELS = channel_bit(TransformChannel::CropLeft) | channel_bit(TransformChannel::CropTop)
+        | channel_bit(TransformChannel::CropRight) | channel_bit(TransformChannel::CropBottom);
+    constexpr ChannelMask ALL_CHANNELS = static_cast<ChannelMask>((1u << TRANSFORM_CHANNEL_COUNT) - 1);
+
+    //! Channel values of a scene item; only the channels in mask are set.
+    struct TransformValues {
+        ChannelMask mask = 0;
+        std::array<float, TRANSFORM_CHANNEL_COUNT> values{};
+
+        TransformValues() = default;
+
+        [[nodiscard]] static TransformValues from_position(const vec2 pos) {
+            TransformValues result;
+            result.set(TransformChannel::PosX, pos.x);
+            result.set(TransformChannel::PosY, pos.y);
+            return result;
+        }
+
+        [[nodiscard]] float get(const TransformChannel channel) const { return values[static_cast<usize>(channel)]; }
+        void set(const TransformChannel channel, const float value) {
+            values[static_cast<usize>(channel)] = value;
+            mask |= channel_bit(channel);
+        }
+    };
+
+    //! Name of a channel in the animate command, e.g. "scale_x" or "crop_left".
+    [[nodiscard]] std::optional<TransformChannel> to_transform_channel(StringView name);
+
+    //! The color filter that applies the opacity, with its settings and the value last written to them, so
+    //! that the video tick neither looks the filter up nor updates it while the opacity stays the same.
+    struct OpacityFilter {
+        SourceRef filter;
+        DataRef settings;
+        float applied = -1.0f;
+    };
+
+    //! The opacity filter of the scene item, added if it has none yet. Scene items have no opacity of their
+    //! own, so the filter sits on the item's source and fades every scene item that shows the source; a
+    //! source shown by more than one scene item is therefore rejected, with the reason in error.
+    [[nodiscard]] std::optional<OpacityFilter> get_opacity_filter(obs_sceneitem_t* item, String& error);
+
+    //! Reads the channels in mask from the scene item; the opacity of an item without filter is 1.
+    [[nodiscard]] TransformValues read_transform(obs_sceneitem_t* item, ChannelMask mask);
+    //! Sets the channels in values.mask on the scene item; crop values are rounded to whole pixels. The
+    //! opacity is only written if opacity holds a filter; the caller decides whether it changed.
+    void apply_transform(obs_sceneitem_t* item, const TransformValues& values, const OpacityFilter* opacity = nullptr);
+}
@@ -0,0 +1,65 @@
+#include "write_queue.h"
+
+namespace ObsCamMove {
+    String WriteQueue::acquire() {
+        if (pool_.empty()) {
+            return {};
+        }
+        String buffer = std::move(pool_.back());
+        pool_.pop_back();
+        return buffer;
+    }
+
+    void WriteQueue::push(String buffer) {
+        if (buffer.empty()) {
+            release(std::move(buffer));
+            return;
+        }
+        pending_bytes_ += buffer.size();
+        pending_.push_back(std::move(buffer));
+    }
+
+    void WriteQueue::push_latest(std::shared_ptr<const String> buffer) {
+        if (buffer && !buffer->empty()) {
+            pending_latest_ = std::move(buffer);
+        }
+    }
+
+    const std::vector<asio::const_buffer>& WriteQueue::begin_write() {
+        // write_buffers_ belongs to the write in flight, so an empty sequence is returned instead
+        static const std::vector<asio::const_buffer> no_buffers;
+        if (writing() || (pending_.empty() && !pending_latest_)) {
+            return no_buffers;
+        }
+
+        // The pending buffers are swapped in, so neither vector reallocates on a warm path
+        std::swap(in_flight_, pending_);
+        in_flight_latest_ = std::move(pending_latest_);
+        pending_bytes_ = 0;
+        write_buffers_.clear();
+        for (const auto& buffer : in_flight_) {
+            write_buffers_.emplace_back(buffer.data(), buffer.size());
+        }
+        if (in_flight_latest_) {
+            write_buffers_.emplace_back(in_flight_latest_->data(), in_flight_latest_->size());
+        }
+        return write_buffers_;
+    }
+
+    void WriteQueue::end_write() {
+        for (auto& buffer : in_flight_) {
+            release(std::move(buffer));
+        }
+        in_flight_.clear();
+        in_flight_latest_.reset();
+        write_buffers_.clear();
+    }
+
+    void WriteQueue::release(String buffer) {
+        // Oversized buffers are dropped so a single large reply does not pin its memory
+        if (pool_.size() < MAX_POOLED_BUFFERS && buffer.capacity() <= MAX_POOLED_CAPACITY) {
+            buffer.clear();
+            pool_.push_back(std::move(buffer));
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "prerequisites.h"
+#include <memory>
+#include <vector>
+
+namespace ObsCamMove {
+    //! Outbound replies of a connection. At most one write is in flight; replies queued meanwhile are
+    //! sent together with the next write as one gather write. Reply buffers are reused through a pool.
+    class WriteQueue {
+    public:
+        //! Replies the client has not read yet; beyond this the connection should be closed.
+        static constexpr usize MAX_PENDING_BYTES = 1024 * 1024;
+
+        //! Returns an empty buffer, reusing the capacity of an already sent reply if possible.
+        [[nodiscard]] String acquire();
+        //! Queues the buffer for sending; empty buffers go straight back to the pool.
+        void push(String buffer);
+        //! Queues a buffer shared with other connections, which replaces the one previously queued this
+        //! way if that has not been sent yet; a client that reads slowly gets the latest state only.
+        void push_latest(std::shared_ptr<const String> buffer);
+
+        //! Moves all queued buffers into a new write and returns its buffer sequence. Returns an empty
+        //! sequence if a write is already in flight or nothing is queued.
+        [[nodiscard]] const std::vector<asio::const_buffer>& begin_write();
+        //! Marks the write in flight as finished and returns its buffers to the pool.
+        void end_write();
+
+        [[nodiscard]] bool writing() const { return !write_buffers_.empty(); }
+        [[nodiscard]] bool overflowed() const { return pending_bytes_ > MAX_PENDING_BYTES; }
+
+    private:
+        static constexpr usize MAX_POOLED_BUFFERS = 16;
+        static constexpr usize MAX_POOLED_CAPACITY = 64 * 1024;
+
+        std::vector<String> pending_;
+        std::vector<String> in_flight_;
+        std::vector<String> pool_;
+        std::shared_ptr<const String> pending_latest_;
+        std::shared_ptr<const String> in_flight_latest_;
+        std::vector<asio::const_buffer> write_buffers_;
+        usize pending_bytes_ = 0;
+
+        void release(String buffer);
+    };
+}
@@ -0,0 +1,26 @@
+import socket
+
+HOST = '127.0.0.1'
+PORT = 5680
+
+with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+    s.connect((HOST, PORT))
+
+    # Kamera, Rahmen und Beschriftung starten im selben Frame
+    messages = [
+        'set_camera_names("scn_facecam")',
+        'batch(move_to(640, 360, 1000, 3); move_to(630, 350, 1000, 3, "scn_frame"); '
+        'move_to(640, 600, 1000, 3, "scn_label"))',
+        # Ein fehlerhaftes Kommando verwirft den ganzen Batch
+        'batch(move_to(0, 0, 1000, 3); move_to(1, 2))',
+        # Nur Animationen lassen sich bündeln, alles andere verwirft den Batch ebenfalls
+        'batch(move_to(0, 0, 1000, 3); set_camera_names("scn_frame"))',
+    ]
+    s.sendall(('\n'.join(messages) + '\n').encode())
+
+    data = b''
+    while data.count(b'\n') < len(messages):
+        data += s.recv(1024)
+
+    for line in data.decode().splitlines():
+        print('Received:', line.strip())
@@ -0,0 +1,43 @@
+import socket
+import struct
+
+HOST = '127.0.0.1'
+PORT = 5680
+
+MAGIC = 0xCB
+OP_MOVE_TO = 0x01
+OP_GET_CAMERA_POSITION = 0x03
+OP_GET_CAMERA_STATE = 0x09
+FLAG_FLOAT = 0x01
+
+
+def frame(opcode, x=0, y=0, duration=0, easing=0, as_float=False):
+    if as_float:
+        return struct.pack('<BBBBffi', opcode, easing, FLAG_FLOAT, 0, x, y, duration)
+    return struct.pack('<BBBBiii', opcode, easing, 0, 0, x, y, duration)
+
+
+def read_reply(s):
+    header = s.recv(8, socket.MSG_WAITALL)
+    opcode, status, _, length = struct.unpack('<BBHI', header)
+    payload = s.recv(length, socket.MSG_WAITALL) if length else b''
+    # Fehler kommen als Text, Abfragen als feste Little-Endian-Felder
+    if status != 0:
+        return opcode, status, payload.decode()
+    if opcode == OP_GET_CAMERA_POSITION:
+        return opcode, status, struct.unpack('<ff', payload)
+    if opcode == OP_GET_CAMERA_STATE:
+        return opcode, status, struct.unpack('<fffff?3x', payload)
+    return opcode, status, payload
+
+
+with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+    s.connect((HOST, PORT))
+
+    # Binaerprotokoll mit dem Magic-Byte auswaehlen und zwei Frames auf einmal senden
+    s.sendall(bytes([MAGIC]) + frame(OP_MOVE_TO, 100.5, 200.25, 500, 3, as_float=True)
+              + frame(OP_GET_CAMERA_POSITION) + frame(OP_GET_CAMERA_STATE))
+
+    print('Received:', read_reply(s))
+    print('Received:', read_reply(s))
+    print('Received:', read_reply(s))
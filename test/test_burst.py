@@ -0,0 +1,23 @@
+import socket
+
+HOST = '127.0.0.1'
+PORT = 5680
+COUNT = 100
+
+with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+    s.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    s.connect((HOST, PORT))
+
+    # 100 Befehle einzeln senden, ohne auf die Antworten zu warten
+    for i in range(COUNT):
+        s.sendall(f'test_echo({i})\n'.encode())
+
+    # Die Antworten muessen vollstaendig und in der richtigen Reihenfolge ankommen
+    data = b''
+    while data.count(b'\n') < COUNT:
+        data += s.recv(4096)
+
+    lines = data.decode().splitlines()
+    for i, line in enumerate(lines):
+        assert line == f'Test echo: {i}', f'Unexpected reply {i}: {line}'
+    print(f'Received {len(lines)} replies in order')
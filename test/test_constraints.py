@@ -0,0 +1,27 @@
+import socket
+import time
+
+HOST = '127.0.0.1'
+PORT = 5680
+
+with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+    s.connect((HOST, PORT))
+
+    # Kamera bleibt im Bild, ist gesperrt und weicht danach dem Rahmen aus
+    messages = [
+        'set_camera_names("scn_facecam")',
+        'set_bounds(0, 0, 1920, 1080)',
+        'move_to(5000, 5000, 1000, 3)',
+        'lock_position(1)',
+        'move_to(0, 0, 1000, 3)',
+        'lock_position(0)',
+        'set_keep_out("", "scn_frame")',
+        'move_to(0, 0, 1000, 3)',
+        'get_camera_position()',
+        'clear_constraints()',
+    ]
+
+    for message in messages:
+        s.sendall((message + '\n').encode())
+        print('Received:', s.recv(1024).decode().strip())
+        time.sleep(1.2)
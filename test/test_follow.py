@@ -0,0 +1,22 @@
+import socket
+import time
+
+HOST = '127.0.0.1'
+PORT = 5680
+
+with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+    s.connect((HOST, PORT))
+
+    # Kamera folgt dem Rahmen mit Versatz und Totzone, während dieser bewegt wird
+    messages = [
+        'set_camera_names("scn_facecam")',
+        'follow("scn_frame", 10, 10, 20, 6)',
+        'move_to(200, 200, 1500, 3, "scn_frame")',
+        'move_to(900, 500, 1500, 3, "scn_frame")',
+        'stop_follow()',
+    ]
+
+    for message in messages:
+        s.sendall((message + '\n').encode())
+        print('Received:', s.recv(1024).decode().strip())
+        time.sleep(2.0)
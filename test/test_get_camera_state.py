@@ -0,0 +1,29 @@
+import socket
+import time
+
+HOST = '127.0.0.1'
+PORT = 5680
+
+with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+    s.connect((HOST, PORT))
+
+    # Zustand während und nach einer Bewegung abfragen (ohne Aufrufe in libobs)
+    messages = [
+        'set_camera_names("scn_facecam")',
+        'move_to(400, 300, 2000, 3)',
+        'get_camera_state()',
+    ]
+
+    for message in messages:
+        s.sendall((message + '\n').encode())
+        print('Received:', s.recv(1024).decode().strip())
+        time.sleep(1.0)
+
+    # Viele Abfragen hintereinander dürfen das Rendern nicht beeinflussen
+    for _ in range(1000):
+        s.sendall(b'get_camera_position()\n')
+        s.recv(1024)
+
+    time.sleep(1.5)
+    s.sendall(b'get_camera_state()\n')
+    print('Received:', s.recv(1024).decode().strip())
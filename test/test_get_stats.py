@@ -0,0 +1,30 @@
+import json
+import socket
+import time
+
+HOST = '127.0.0.1'
+PORT = 5680
+
+with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+    s.connect((HOST, PORT))
+
+    # Statistik zuruecksetzen, eine Bewegung ausfuehren und danach auslesen
+    messages = [
+        'get_stats(1)',
+        'set_camera_names("scn_facecam")',
+        'move_to(640, 360, 500, 3)',
+    ]
+    s.sendall(('\n'.join(messages) + '\n').encode())
+    time.sleep(1.0)
+    s.sendall(b'get_stats()\n')
+
+    data = b''
+    while data.count(b'\n') < len(messages) + 1:
+        data += s.recv(65536)
+
+    stats = json.loads(data.decode().splitlines()[-1])
+    for command, values in stats['commands'].items():
+        if values['count'] > 0:
+            print(command, values)
+    print('connection', stats['connection'])
+    print('animation', stats['animation'])
@@ -0,0 +1,26 @@
+import socket
+import time
+
+HOST = '127.0.0.1'
+PORT = 5680
+
+with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+    s.connect((HOST, PORT))
+
+    messages = [
+        'set_camera_names("scn_facecam")',
+        'set_interrupt_moves(1)',
+        'move_to(1200, 0, 2000, 4)',
+    ]
+    s.sendall(('\n'.join(messages) + '\n').encode())
+
+    # Mitten in der Bewegung das Ziel korrigieren; die Kamera soll ohne Sprung weiterfahren
+    time.sleep(0.8)
+    s.sendall(b'move_to(600, 600, 1500, 1)\n')
+
+    data = b''
+    while data.count(b'\n') < len(messages) + 1:
+        data += s.recv(1024)
+
+    for line in data.decode().splitlines():
+        print('Received:', line.strip())
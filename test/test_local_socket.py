@@ -0,0 +1,18 @@
+import socket
+
+# OBS muss mit OBS_CAMERA_MOVE_SOCKET=/tmp/obs_camera_move.sock gestartet sein
+SOCKET_PATH = '/tmp/obs_camera_move.sock'
+
+with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as s:
+    s.connect(SOCKET_PATH)
+
+    # Gleiche Befehle wie über TCP, nur ohne den Loopback-Stack
+    messages = [
+        'set_camera_names("scn_facecam")',
+        'get_camera_position()',
+        'move_to(400, 300, 1000, 3)',
+    ]
+
+    for message in messages:
+        s.sendall((message + '\n').encode())
+        print('Received:', s.recv(1024).decode().strip())
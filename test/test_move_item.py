@@ -0,0 +1,23 @@
+import socket
+
+HOST = '127.0.0.1'
+PORT = 5680
+
+with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+    s.connect((HOST, PORT))
+
+    # Nachricht senden
+    message = 'move_to(0,0,840,10,"scn_facecam")'
+    s.sendall(message.encode())
+
+    # Antwort empfangen
+    data = s.recv(1024)
+    print('Received:', data.decode().strip())
+
+    # Nachricht senden
+    message = 'move_to(1600,0,840,10,"scn_overlay")'
+    s.sendall(message.encode())
+
+    # Antwort empfangen
+    data = s.recv(1024)
+    print('Received:', data.decode().strip())
@@ -0,0 +1,21 @@
+import socket
+
+HOST = '127.0.0.1'
+PORT = 5680
+
+with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+    s.connect((HOST, PORT))
+
+    # Kamera in einem Bogen ueber drei Wegpunkte bewegen (2 Sekunden, EaseInOutQuad)
+    messages = [
+        'set_camera_names("scn_facecam")',
+        'move_path(400, 0, 800, 300, 400, 600, 2000, 4)',
+    ]
+    s.sendall(('\n'.join(messages) + '\n').encode())
+
+    data = b''
+    while data.count(b'\n') < len(messages):
+        data += s.recv(1024)
+
+    for line in data.decode().splitlines():
+        print('Received:', line.strip())
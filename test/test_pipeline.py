@@ -0,0 +1,23 @@
+import socket
+
+HOST = '127.0.0.1'
+PORT = 5680
+
+with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+    s.connect((HOST, PORT))
+
+    # Mehrere Nachrichten (durch Zeilenumbruch getrennt) auf einmal senden
+    messages = [
+        'set_camera_names("scn_facecam")',
+        'get_camera_name()',
+        'get_camera_position()',
+    ]
+    s.sendall(('\n'.join(messages) + '\n').encode())
+
+    # Antworten empfangen (eine Zeile pro Nachricht)
+    data = b''
+    while data.count(b'\n') < len(messages):
+        data += s.recv(1024)
+
+    for line in data.decode().splitlines():
+        print('Received:', line.strip())
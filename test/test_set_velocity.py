@@ -0,0 +1,37 @@
+import math
+import socket
+import time
+
+HOST = '127.0.0.1'
+PORT = 5680
+
+with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+    s.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    s.connect((HOST, PORT))
+
+    messages = [
+        'set_camera_names("scn_facecam")',
+        'set_motion_limits(1500, 6000)',
+    ]
+    s.sendall(('\n'.join(messages) + '\n').encode())
+
+    # Wie ein Gamepad: zwei Sekunden lang mit 200 Hz eine Kreisbewegung senden
+    start = time.time()
+    sent = 0
+    while time.time() - start < 2.0:
+        angle = (time.time() - start) * math.pi
+        s.sendall(f'set_velocity({int(400 * math.cos(angle))}, {int(400 * math.sin(angle))})\n'.encode())
+        sent += 1
+        time.sleep(0.005)
+
+    # Zum Schluss ein Ziel anfahren und dort anhalten
+    s.sendall(b'set_target(0, 0)\nget_camera_position()\n')
+    sent += 1
+
+    data = b''
+    while data.count(b'\n') < len(messages) + sent + 1:
+        data += s.recv(4096)
+
+    lines = data.decode().splitlines()
+    print(f'Sent {sent} control commands, {lines.count("OK")} acknowledged')
+    print('Received:', lines[-1])
@@ -0,0 +1,33 @@
+import socket
+import time
+
+HOST = '127.0.0.1'
+PORT = 5680
+
+with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+    s.connect((HOST, PORT))
+
+    # Position abonnieren statt abzufragen; der Server sendet nur bei Aenderungen
+    messages = [
+        'set_camera_names("scn_facecam")',
+        'subscribe_position(30)',
+        'move_to(640, 360, 1000, 3)',
+    ]
+    s.sendall(('\n'.join(messages) + '\n').encode())
+
+    s.settimeout(0.5)
+    data = b''
+    start = time.time()
+    while time.time() - start < 2.0:
+        try:
+            data += s.recv(4096)
+        except socket.timeout:
+            pass
+
+    s.sendall(b'subscribe_position(0)\n')
+
+    lines = data.decode().splitlines()
+    updates = [line for line in lines if line.startswith('camera-position')]
+    for line in lines:
+        print('Received:', line.strip())
+    print(f'{len(updates)} Positionen in 2 Sekunden empfangen')
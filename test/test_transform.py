@@ -0,0 +1,24 @@
+import socket
+import time
+
+HOST = '127.0.0.1'
+PORT = 5680
+
+with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+    s.connect((HOST, PORT))
+
+    # Schwenk und Zoom in einem Kommando, danach Zuschneiden und Einblenden gemeinsam mit einer Bewegung
+    messages = [
+        'set_camera_names("scn_facecam")',
+        'animate(1000, 3, x=400, y=200, scale=1.5, opacity=0.5)',
+        'get_scale()',
+        'batch(move_to(640, 360, 1000, 3); crop_to(0, 20, 0, 20, 1000, 3); fade_in(1000); zoom(0.5, 1000, 3))',
+        'rotate(0, 500, 3)',
+        'get_scale()',
+    ]
+
+    for message in messages:
+        s.sendall((message + '\n').encode())
+        print('Received:', s.recv(1024).decode().strip())
+        # Animationen abwarten, bevor die nächste beginnt
+        time.sleep(1.2)